@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+
+namespace bench
+{
+    // A run gets an iteration count and returns how many items it processed
+    using Run = std::function<size_t(size_t)>;
+
+    struct Benchmark
+    {
+        std::string_view name;
+        std::string_view unit;
+        Run run;
+    };
+
+    inline auto registry() -> std::vector<Benchmark>&
+    {
+        static auto benchmarks = std::vector<Benchmark>{};
+        return benchmarks;
+    }
+
+    struct Registration
+    {
+        Registration(std::string_view name, std::string_view unit, Run run)
+        {
+            registry().push_back({ name, unit, std::move(run) });
+        }
+    };
+
+    // Calls to the global operator new since the start, bumped by the replacement in main.cpp
+    inline auto allocations = std::atomic<size_t>{0};
+
+    // Time a run spent in setup, measure() takes it out of the run's time
+    inline auto setup_time = std::chrono::steady_clock::duration{};
+
+    // Counts the scope it lives in as setup, for runs that have to rebuild their inputs between items
+    class Setup
+    {
+    public:
+        Setup() = default;
+        Setup(const Setup&) = delete;
+        auto operator=(const Setup&) -> Setup& = delete;
+
+        ~Setup()
+        {
+            setup_time += std::chrono::steady_clock::now() - start_;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    };
+
+    // Keeps the optimizer from dropping a result that is never read
+    template <typename T>
+    inline void keep(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
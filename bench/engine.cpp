@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <print>
+#include <span>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "engine/game.hpp"
+#include "engine/placements.hpp"
+#include "proto/protocol.hpp"
+
+
+namespace
+{
+    // Four rows at the bottom with column 9 open, the top 4 - rows_cleared of them have
+    // column 8 open as well, so an I dropped into column 9 clears exactly rows_cleared rows
+    auto stack(size_t rows_cleared) -> tetriz::Board
+    {
+        auto board = tetriz::Board{};
+        for (auto row = 0uz; row < 4; ++row)
+        {
+            auto& cells = board[tetriz::board_height - 4 + row];
+            std::ranges::fill(cells, tetriz::Block::Blue);
+            cells[9] = tetriz::Block::Void;
+            if (row < 4 - rows_cleared)
+                cells[8] = tetriz::Block::Void;
+        }
+
+        return board;
+    }
+
+    // Fresh game on the board with the shape as the current piece
+    auto fixture(const tetriz::Board& board, tetriz::TetrominoShape shape) -> tetriz::GameSnapshot
+    {
+        auto snapshot = tetriz::Game(1).snapshot();
+        snapshot.board = board;
+        snapshot.occupancy = tetriz::BitBoard(board);
+        snapshot.current = tetriz::StandardSpawn::spawn(tetriz::BitBoard(board), shape).tetromino;
+        return snapshot;
+    }
+
+    [[noreturn]] void fail(std::string_view message)
+    {
+        std::println(stderr, "fixture: {}", message);
+        std::abort();
+    }
+
+    // First placement of the current piece that clears the given number of rows
+    auto clearing_placement(const tetriz::GameSnapshot& snapshot, size_t rows) -> tetriz::Tetromino
+    {
+        const auto game = tetriz::Game(snapshot);
+        for (const auto& placement : find_placements(game))
+        {
+            auto placed = game;
+            placed.place(placement);
+            if (placed.score() - game.score() == rows)
+                return placement;
+        }
+
+        fail("no placement clears the rows");
+    }
+
+    // A resting piece whose rotation only fits after a kick
+    auto kicked_piece(const tetriz::BitBoard& board) -> tetriz::Tetromino
+    {
+        for (const auto shape : magic_enum::enum_values<tetriz::TetrominoShape>())
+        {
+            auto placements = tetriz::PlacementList{};
+            find_placements(board, tetriz::StandardSpawn::spawn(board, shape).tetromino, placements);
+
+            for (const auto& placement : placements)
+                if (const auto rotation = tetriz::rotate(board, placement); rotation && rotation->kick > 0)
+                    return placement;
+        }
+
+        fail("no rotation needs a kick");
+    }
+
+    // Copies of a fixture game, restored outside the timed part so that a run only measures
+    // what it does to them. Each copy is used once per refill.
+    class Fixtures
+    {
+        static constexpr auto count = 64uz;
+
+    public:
+        explicit Fixtures(const tetriz::GameSnapshot& snapshot)
+            : snapshot_(snapshot)
+            , games_(count, tetriz::Game(snapshot))
+        {}
+
+        // Fresh games, as many as are left of the items but at most count
+        auto refill(size_t items) -> std::span<tetriz::Game>
+        {
+            const auto setup = bench::Setup();
+            const auto games = std::span(games_).first(std::min(items, count));
+            for (auto& game : games)
+                game.restore(snapshot_);
+
+            return games;
+        }
+
+    private:
+        tetriz::GameSnapshot snapshot_;
+        std::vector<tetriz::Game> games_;
+    };
+
+    auto lowered(tetriz::Tetromino tetromino, int rows) -> tetriz::Tetromino
+    {
+        tetromino.coordinates.y += rows;
+        return tetromino;
+    }
+
+    const auto move = bench::Registration("game/move", "moves", [](size_t iterations) {
+        auto game = tetriz::Game(fixture(stack(0), tetriz::TetrominoShape::T));
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            game.move(tetriz::Direction::Left);
+            game.move(tetriz::Direction::Right);
+        }
+
+        bench::keep(game.current());
+        return 2 * iterations;
+    });
+
+    // Four rotations bring the piece back, in the open every one passes the first kick test
+    const auto rotate = bench::Registration("game/rotate", "rotations", [](size_t iterations) {
+        auto game = tetriz::Game(fixture(stack(0), tetriz::TetrominoShape::T));
+        game.move(tetriz::Direction::Down);
+        game.move(tetriz::Direction::Down);
+
+        for (auto i = 0uz; i < iterations; ++i)
+            for (auto turn = 0; turn < 4; ++turn)
+                game.rotate();
+
+        bench::keep(game.current());
+        return 4 * iterations;
+    });
+
+    const auto rotate_open = bench::Registration("board/rotate", "rotations", [](size_t iterations) {
+        const auto board = tetriz::BitBoard(stack(0));
+        const auto piece = lowered(tetriz::StandardSpawn::spawn(board, tetriz::TetrominoShape::T).tetromino, 2);
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(piece);
+            bench::keep(tetriz::rotate(board, piece));
+        }
+
+        return iterations;
+    });
+
+    const auto rotate_kicked = bench::Registration("board/rotate_kicked", "rotations", [](size_t iterations) {
+        const auto board = tetriz::BitBoard(stack(0));
+        const auto piece = kicked_piece(board);
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(piece);
+            bench::keep(tetriz::rotate(board, piece));
+        }
+
+        return iterations;
+    });
+
+    // Rollback cost, the cases below restore their games outside the timed part
+    const auto restore = bench::Registration("game/restore", "restores", [](size_t iterations) {
+        const auto snapshot = fixture(stack(0), tetriz::TetrominoShape::T);
+        auto game = tetriz::Game(snapshot);
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(snapshot);
+            game.restore(snapshot);
+            bench::keep(game);
+        }
+
+        return iterations;
+    });
+
+    const auto drop = bench::Registration("game/drop", "drops", [](size_t iterations) {
+        auto fixtures = Fixtures(fixture(stack(0), tetriz::TetrominoShape::T));
+
+        for (auto done = 0uz; done < iterations;)
+            for (auto& game : fixtures.refill(iterations - done))
+            {
+                game.drop();
+                bench::keep(game);
+                ++done;
+            }
+
+        return iterations;
+    });
+
+    auto clear_lines(size_t rows) -> bench::Run
+    {
+        return [rows](size_t iterations) {
+            const auto snapshot = fixture(stack(rows), tetriz::TetrominoShape::I);
+            const auto placement = clearing_placement(snapshot, rows);
+            auto fixtures = Fixtures(snapshot);
+
+            for (auto done = 0uz; done < iterations;)
+                for (auto& game : fixtures.refill(iterations - done))
+                {
+                    game.place(placement);
+                    bench::keep(game);
+                    ++done;
+                }
+
+            return iterations;
+        };
+    }
+
+    const auto clear_0 = bench::Registration("game/clear_lines/0", "locks", clear_lines(0));
+    const auto clear_1 = bench::Registration("game/clear_lines/1", "locks", clear_lines(1));
+    const auto clear_2 = bench::Registration("game/clear_lines/2", "locks", clear_lines(2));
+    const auto clear_3 = bench::Registration("game/clear_lines/3", "locks", clear_lines(3));
+    const auto clear_4 = bench::Registration("game/clear_lines/4", "locks", clear_lines(4));
+
+    const auto poll = bench::Registration("bag/poll", "pieces", [](size_t iterations) {
+        auto bag = tetriz::TetrominoBag(5);
+
+        for (auto i = 0uz; i < iterations; ++i)
+            bench::keep(bag.poll());
+
+        return iterations;
+    });
+
+    const auto peek = bench::Registration("bag/peek", "peeks", [](size_t iterations) {
+        const auto bag = tetriz::TetrominoBag(5);
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(bag);
+            bench::keep(bag.peek<4>());
+        }
+
+        return iterations;
+    });
+
+    // What a frame of the renderer reads, every cell of the board with the piece on it
+    auto checksum(const tetriz::BoardCells auto& board) -> size_t
+    {
+        auto occupied = 0uz;
+        for (auto y = 0uz; y < tetriz::board_height; ++y)
+        {
+            const auto& row = board[y];
+            for (auto x = 0uz; x < tetriz::board_width; ++x)
+                occupied += is_occupied(row[x]);
+        }
+
+        return occupied;
+    }
+
+    const auto project = bench::Registration("board/project_on_board", "frames", [](size_t iterations) {
+        const auto game = tetriz::Game(fixture(stack(2), tetriz::TetrominoShape::L));
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            auto board = game.board();
+            tetriz::project_on_board(board, game.current());
+            bench::keep(checksum(board));
+        }
+
+        return iterations;
+    });
+
+    const auto view = bench::Registration("board/view", "frames", [](size_t iterations) {
+        const auto game = tetriz::Game(fixture(stack(2), tetriz::TetrominoShape::L));
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(game);
+            bench::keep(checksum(game.view()));
+        }
+
+        return iterations;
+    });
+
+    const auto serialize = bench::Registration("proto/serialize_game", "datagrams", [](size_t iterations) {
+        const auto game = tetriz::Game(fixture(stack(2), tetriz::TetrominoShape::L));
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(game);
+            bench::keep(tetriz::proto::serialize_game(1, game));
+        }
+
+        return iterations;
+    });
+
+    const auto deserialize = bench::Registration("proto/deserialize", "datagrams", [](size_t iterations) {
+        const auto message = tetriz::proto::serialize_game(1, tetriz::Game(fixture(stack(2), tetriz::TetrominoShape::L)));
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            bench::keep(message);
+            bench::keep(tetriz::proto::deserialize(message));
+        }
+
+        return iterations;
+    });
+}
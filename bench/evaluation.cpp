@@ -0,0 +1,55 @@
+#include <vector>
+
+#include "benchmark.hpp"
+#include "bot/evaluation.hpp"
+#include "engine/game.hpp"
+
+
+namespace
+{
+    constexpr auto lanes = 16uz;
+
+    // Boards from random play, so that the kernels see realistic stacks
+    auto sample_batches() -> std::vector<tetriz::bot::BoardBatch<lanes>>
+    {
+        auto batches = std::vector<tetriz::bot::BoardBatch<lanes>>(64);
+        auto game = tetriz::Game(7);
+
+        for (auto& batch : batches)
+            for (auto index = 0uz; index < lanes; ++index)
+            {
+                for (auto step = 0; step < 12; ++step)
+                {
+                    if (game.finished())
+                        game = tetriz::Game(step);
+
+                    game.move(step % 3 ? tetriz::Direction::Right : tetriz::Direction::Left);
+                    if (step % 4 == 0)
+                        game.drop();
+                }
+
+                batch.load(index, game.occupancy());
+            }
+
+        return batches;
+    }
+
+    template <typename Kernel>
+    auto score_boards(Kernel&& kernel)
+    {
+        return [batches = sample_batches(), kernel](size_t iterations) {
+            for (auto i = 0uz; i < iterations; ++i)
+                bench::keep(kernel(batches[i % batches.size()]));
+
+            return iterations * lanes;
+        };
+    }
+
+    const auto scalar = bench::Registration("evaluation/scalar", "boards", score_boards([](const auto& batch) {
+        return tetriz::bot::features_scalar(batch);
+    }));
+
+    const auto simd = bench::Registration("evaluation/simd", "boards", score_boards([](const auto& batch) {
+        return tetriz::bot::features(batch);
+    }));
+}
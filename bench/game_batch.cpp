@@ -0,0 +1,73 @@
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "engine/game.hpp"
+#include "engine/game_batch.hpp"
+#include "engine/random.hpp"
+
+
+namespace
+{
+    constexpr auto games = 16384uz;
+    constexpr auto steps = 64uz;
+
+    // One row of inputs per step, drops are common enough that pieces keep locking
+    auto sample_moves() -> std::vector<std::array<tetriz::Move, games>>
+    {
+        constexpr auto weighted = std::to_array({
+            tetriz::Move::Left, tetriz::Move::Right, tetriz::Move::Down,
+            tetriz::Move::Down, tetriz::Move::Rotate, tetriz::Move::Drop,
+        });
+
+        auto random = tetriz::Pcg32(3);
+        auto moves = std::vector<std::array<tetriz::Move, games>>(steps);
+        for (auto& step : moves)
+            for (auto& move : step)
+                move = weighted[tetriz::uniform_below(random, weighted.size())];
+
+        return moves;
+    }
+
+    auto seeds() -> std::array<uint32_t, games>
+    {
+        auto seeds = std::array<uint32_t, games>{};
+        std::iota(seeds.begin(), seeds.end(), 0u);
+        return seeds;
+    }
+
+    // Finished games restart so that the runs keep measuring live games
+    const auto sequential = bench::Registration("game/sequential", "game-steps", [](size_t iterations) {
+        const auto moves = sample_moves();
+        const auto initial = seeds();
+        auto reference = std::vector<tetriz::Game>(initial.begin(), initial.end());
+
+        for (auto i = 0uz; i < iterations; ++i)
+            for (auto game = 0uz; game < games; ++game)
+            {
+                reference[game].apply(moves[i % steps][game]);
+                if (reference[game].finished())
+                    reference[game] = tetriz::Game(i);
+            }
+
+        bench::keep(reference.front().score());
+        return iterations * games;
+    });
+
+    const auto lockstep = bench::Registration("game_batch/lockstep", "game-steps", [](size_t iterations) {
+        const auto moves = sample_moves();
+        auto batch = std::make_unique<tetriz::GameBatch<games>>(seeds());
+
+        for (auto i = 0uz; i < iterations; ++i)
+        {
+            batch->apply(moves[i % steps]);
+            for (auto game = 0uz; game < games; ++game)
+                if (batch->finished(game))
+                    batch->reset(game, i);
+        }
+
+        bench::keep(batch->score(0));
+        return iterations * games;
+    });
+}
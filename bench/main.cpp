@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string_view>
+
+#include "benchmark.hpp"
+
+
+// Every allocation in the process goes through here so that runs can report allocations per item
+auto operator new(size_t size) -> void*
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* memory = std::malloc(size ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+auto operator new(size_t size, std::align_val_t alignment) -> void*
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<size_t>(alignment);
+    if (auto* memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+
+struct Measurement
+{
+    double rate;
+    double allocations;
+};
+
+// Doubles the iteration count until a run takes long enough to time, then reports its rate
+auto measure(const bench::Benchmark& benchmark) -> Measurement
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto target = std::chrono::milliseconds(250);
+
+    for (auto iterations = 1uz;; iterations *= 2)
+    {
+        const auto allocations = bench::allocations.load(std::memory_order_relaxed);
+        bench::setup_time = {};
+        const auto start = clock::now();
+        const auto items = benchmark.run(iterations);
+        const auto elapsed = std::chrono::duration<double>(clock::now() - start - bench::setup_time);
+
+        if (elapsed >= target)
+        {
+            const auto allocated = bench::allocations.load(std::memory_order_relaxed) - allocations;
+            return { items / elapsed.count(), static_cast<double>(allocated) / items };
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const auto filter = argc > 1 ? std::string_view(argv[1]) : std::string_view();
+
+    std::println("{:<32} {:>16} {:>12} {:>12}", "benchmark", "rate", "ns/item", "allocs/item");
+
+    for (const auto& benchmark : bench::registry())
+        if (benchmark.name.contains(filter))
+        {
+            const auto [rate, allocations] = measure(benchmark);
+            std::println("{:<32} {:>14.0f}/s {:>12.2f} {:>12.3f} ({})",
+                benchmark.name, rate, 1e9 / rate, allocations, benchmark.unit);
+        }
+}
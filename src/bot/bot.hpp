@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <future>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "bot/evaluation.hpp"
+#include "bot/transposition_table.hpp"
+#include "engine/finesse.hpp"
+#include "engine/game.hpp"
+#include "engine/placements.hpp"
+#include "util/thread_pool.hpp"
+
+
+namespace tetriz::bot
+{
+    struct SearchOptions
+    {
+        // Pieces placed along every line, the current one and then the preview
+        size_t depth = 3;
+        size_t beam_width = 16;
+        bool use_swap = true;
+        // Entries of the board score table the search tasks share, rounded up to a power of two
+        size_t table_size = 1uz << 18;
+    };
+
+    struct Decision
+    {
+        bool swap = false;
+        Tetromino placement{};
+    };
+
+    constexpr void apply(Game& game, const Decision& decision)
+    {
+        if (decision.swap)
+            game.swap();
+
+        game.place(decision.placement);
+    }
+
+    // Inputs that carry out the decision on a client, the swap first when there is one
+    constexpr auto moves(const Game& game, const Decision& decision) -> std::optional<std::vector<Move>>
+    {
+        if (!decision.swap)
+            return finesse(game, decision.placement);
+
+        auto swapped = game;
+        swapped.swap();
+
+        auto moves = finesse(swapped, decision.placement);
+        if (moves)
+            moves->insert(moves->begin(), Move::Swap);
+
+        return moves;
+    }
+
+    // Calls expand(decision, child) for every game reachable by locking the next piece,
+    // the swap slot counts as another candidate piece
+    template <typename Expand>
+    constexpr void expand(const Game& game, bool use_swap, Expand&& on_child)
+    {
+        auto placements = PlacementList{};
+
+        for (const auto swap : { false, true })
+        {
+            if (swap && (!use_swap || game.just_swapped()))
+                break;
+
+            auto base = game;
+            if (swap)
+                base.swap();
+
+            if (base.finished())
+                continue;
+
+            find_placements(base.occupancy(), base.current(), placements);
+            for (const auto& placement : placements)
+            {
+                auto child = base;
+                child.place(placement);
+                on_child(Decision{ swap, placement }, child);
+            }
+        }
+    }
+
+    // Beam search over the preview, every root candidate is searched as its own task on the pool.
+    // decide() runs pool tasks while it waits, so it may itself be called from a task of the pool.
+    class Bot
+    {
+        static constexpr auto max_depth = 1uz + 7;
+        static constexpr auto batch_size = 16uz;
+
+        struct Node
+        {
+            Game game;
+            uint64_t hash;
+            float value;
+        };
+
+        // Value of a board without the lines term, which depends on where the search started
+        struct BoardScore
+        {
+            float value;
+            uint32_t reserved = 0;
+        };
+
+    public:
+        explicit Bot(ThreadPool& pool, Weights weights = {}, SearchOptions options = {})
+            : pool_(pool)
+            , weights_(weights)
+            , options_(options)
+            , scores_(options.table_size)
+        {
+            options_.depth = std::clamp(options_.depth, 1uz, max_depth);
+            options_.beam_width = std::max(options_.beam_width, 1uz);
+        }
+
+        auto decide(const Game& game) const -> std::optional<Decision>
+        {
+            if (game.finished())
+                return std::nullopt;
+
+            auto candidates = std::vector<Decision>{};
+            auto results = std::vector<std::future<float>>{};
+
+            expand(game, options_.use_swap, [&](const Decision& decision, const Game& child) {
+                candidates.push_back(decision);
+                results.push_back(pool_.submit([this, child, lines = game.score()] {
+                    return search(child, lines);
+                }));
+            });
+
+            // Ties go to the earliest candidate so the choice does not depend on the thread count
+            auto best = std::optional<Decision>{};
+            auto best_value = -std::numeric_limits<float>::infinity();
+            for (auto i = 0uz; i < candidates.size(); ++i)
+                if (const auto value = pool_.wait(results[i]); !best || value > best_value)
+                {
+                    best = candidates[i];
+                    best_value = value;
+                }
+
+            return best;
+        }
+
+        auto weights() const -> const Weights& { return weights_; }
+        auto options() const -> const SearchOptions& { return options_; }
+
+    private:
+        // Every path to a node's value adds the lines term to the board score the same way,
+        // so a score from the table is exactly the one a fresh evaluation would give
+        auto value(const Game& game, float board_score, uint16_t root_lines) const -> float
+        {
+            if (game.finished())
+                return -std::numeric_limits<float>::infinity();
+
+            return board_score + weights_.lines * (game.score() - root_lines);
+        }
+
+        auto value(const Game& game, uint16_t root_lines) const -> float
+        {
+            return value(game, evaluate(game.occupancy(), weights_), root_lines);
+        }
+
+        // Same as value() for every node. Boards another task already scored come from the shared
+        // table, the rest go through the batch evaluator and are stored for the others.
+        void score(std::span<Node> nodes, uint16_t root_lines) const
+        {
+            auto batch = BoardBatch<batch_size>{};
+            auto pending = std::array<Node*, batch_size>{};
+            auto loaded = 0uz;
+
+            const auto evaluate_batch = [&] {
+                if (loaded == 0)
+                    return;
+
+                const auto features = bot::features(batch);
+                for (auto index = 0uz; index < loaded; ++index)
+                {
+                    const auto board_score = evaluate(features[index], weights_);
+                    scores_.store(pending[index]->game.occupancy().hash(), { board_score });
+                    pending[index]->value = value(pending[index]->game, board_score, root_lines);
+                }
+
+                loaded = 0;
+            };
+
+            for (auto& node : nodes)
+            {
+                if (node.game.finished())
+                    node.value = -std::numeric_limits<float>::infinity();
+                else if (const auto stored = scores_.probe(node.game.occupancy().hash()); stored)
+                    node.value = value(node.game, stored->value, root_lines);
+                else
+                {
+                    batch.load(loaded, node.game.occupancy());
+                    pending[loaded++] = &node;
+
+                    if (loaded == batch_size)
+                        evaluate_batch();
+                }
+            }
+
+            evaluate_batch();
+        }
+
+        // Different orders of the same pieces often meet in one position, only the first of them is kept.
+        // seen is an open addressed set of hashes that keeps its storage from one level to the next.
+        static void drop_repeated(std::vector<Node>& nodes, std::vector<uint64_t>& seen)
+        {
+            seen.assign(std::bit_ceil(2 * nodes.size()), 0);
+            const auto mask = seen.size() - 1;
+
+            auto kept = 0uz;
+            for (auto index = 0uz; index < nodes.size(); ++index)
+            {
+                const auto hash = nodes[index].hash;
+                auto slot = hash & mask;
+                while (seen[slot] != 0 && seen[slot] != hash)
+                    slot = (slot + 1) & mask;
+
+                if (seen[slot] == hash && hash != 0)
+                    continue;
+
+                seen[slot] = hash;
+                if (kept != index)
+                    nodes[kept] = nodes[index];
+                ++kept;
+            }
+
+            nodes.erase(nodes.begin() + kept, nodes.end());
+        }
+
+        // Best value among the leaves that survive the beam below the root candidate
+        auto search(const Game& root, uint16_t root_lines) const -> float
+        {
+            // Every thread keeps its buffers from one search to the next, so warm searches do not allocate
+            thread_local auto beam = std::vector<Node>{};
+            thread_local auto next = std::vector<Node>{};
+            thread_local auto seen = std::vector<uint64_t>{};
+
+            beam.assign(1, Node{ root, root.hash(), value(root, root_lines) });
+
+            for (auto depth = 1uz; depth < options_.depth; ++depth)
+            {
+                next.clear();
+                for (const auto& node : beam)
+                    expand(node.game, options_.use_swap, [&](const Decision&, const Game& child) {
+                        next.push_back(Node{ child, child.hash(), 0.0f });
+                    });
+
+                drop_repeated(next, seen);
+
+                if (next.empty())
+                    break;
+
+                score(next, root_lines);
+
+                const auto width = std::min(options_.beam_width, next.size());
+                std::ranges::partial_sort(next, next.begin() + width, std::ranges::greater{}, &Node::value);
+                next.erase(next.begin() + width, next.end());
+                std::swap(beam, next);
+            }
+
+            return std::ranges::max(beam, {}, &Node::value).value;
+        }
+
+        ThreadPool& pool_;
+        Weights weights_;
+        SearchOptions options_;
+        // Board scores by occupancy hash, shared by every search task and every decide() call
+        mutable TranspositionTable<BoardScore> scores_;
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "bot/bot.hpp"
+#include "engine/game.hpp"
+
+
+namespace tetriz::bot
+{
+    // Self-play samples for training placement models. A dataset file is a DatasetHeader followed
+    // directly by record_count DatasetRecords, so a reader can map the file and index it in place.
+    // Fields are stored as the host lays them out.
+
+    constexpr inline auto dataset_magic = std::array<char, 4>{ 'T', 'Z', 'D', 'S' };
+    // Bumped whenever the record layout or the meaning of a field changes
+    constexpr inline auto dataset_version = uint16_t{1};
+
+    constexpr inline auto dataset_preview = 5uz;
+
+    // One decision of the bot, the state it saw, what it did and how the game went on from there
+    struct DatasetRecord
+    {
+        // Bit x of rows[y] is the cell x of board row y, row 0 at the top
+        std::array<RowMask, board_height> rows{};
+        TetrominoShape current{};
+        // Shape in the swap slot, 0 when it is empty
+        uint8_t swapped = 0;
+        std::array<TetrominoShape, dataset_preview> preview{};
+
+        // The decision, the placement is where the piece locked
+        uint8_t swap = 0;
+        TetrominoRotation rotation{};
+        int8_t x = 0;
+        int8_t y = 0;
+
+        // Outcome, lines_after and pieces_after count this placement and everything after it
+        uint8_t lines = 0;
+        uint8_t topped_out = 0;
+        std::array<uint8_t, 3> reserved{};
+        uint16_t lines_after = 0;
+        uint16_t pieces_after = 0;
+    };
+
+    static_assert(sizeof(DatasetRecord) == 64);
+    static_assert(std::is_trivially_copyable_v<DatasetRecord> && std::is_standard_layout_v<DatasetRecord>);
+
+    struct DatasetHeader
+    {
+        std::array<char, 4> magic = dataset_magic;
+        uint16_t version = dataset_version;
+        uint16_t record_size = sizeof(DatasetRecord);
+        uint16_t board_width = tetriz::board_width;
+        uint16_t board_height = tetriz::board_height;
+        uint16_t preview = dataset_preview;
+        uint16_t reserved = 0;
+        // Written when the generator finishes, until then it is zero and the file size tells the count
+        uint64_t record_count = 0;
+        std::array<uint8_t, 40> padding{};
+    };
+
+    static_assert(sizeof(DatasetHeader) == 64);
+
+    // The state and decision part of a record, the outcome is filled in once the game is over
+    constexpr auto make_record(const Game& game, const Decision& decision) -> DatasetRecord
+    {
+        auto record = DatasetRecord{
+            .current = game.current().shape,
+            .swapped = game.swapped() ? static_cast<uint8_t>(*game.swapped()) : uint8_t{0},
+            .preview = game.bag().peek<dataset_preview>(),
+            .swap = decision.swap,
+            .rotation = decision.placement.rotation,
+            .x = decision.placement.coordinates.x,
+            .y = decision.placement.coordinates.y,
+        };
+        std::ranges::copy(game.occupancy().rows(), record.rows.begin());
+
+        return record;
+    }
+
+    // Turns the lines of every placement of one game into what followed it
+    constexpr void fill_outcome(std::span<DatasetRecord> game, bool topped_out)
+    {
+        constexpr auto saturated = uint32_t{UINT16_MAX};
+
+        auto lines = uint32_t{0};
+        auto pieces = uint32_t{0};
+        for (auto& record : game | std::views::reverse)
+        {
+            lines += record.lines;
+            ++pieces;
+
+            record.lines_after = static_cast<uint16_t>(std::min(lines, saturated));
+            record.pieces_after = static_cast<uint16_t>(std::min(pieces, saturated));
+            record.topped_out = topped_out;
+        }
+    }
+
+    // One game from the seed into records, every record already carries its outcome
+    inline void self_play(const Bot& bot, uint32_t seed, size_t max_pieces, std::vector<DatasetRecord>& records)
+    {
+        records.clear();
+        auto game = Game(seed);
+
+        while (records.size() < max_pieces)
+        {
+            const auto decision = bot.decide(game);
+            if (!decision)
+                break;
+
+            auto record = make_record(game, *decision);
+            const auto score = game.score();
+            apply(game, *decision);
+            record.lines = static_cast<uint8_t>(game.score() - score);
+
+            records.push_back(record);
+        }
+
+        fill_outcome(records, game.finished());
+    }
+
+    // The records of a mapped dataset file, nothing when the header is not one this code understands
+    inline auto dataset_records(std::span<const std::byte> file) -> std::optional<std::span<const DatasetRecord>>
+    {
+        if (file.size() < sizeof(DatasetHeader))
+            return std::nullopt;
+
+        auto header = DatasetHeader{};
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.magic != dataset_magic
+            || header.version != dataset_version
+            || header.record_size != sizeof(DatasetRecord)
+            || header.board_width != board_width
+            || header.board_height != board_height
+            || header.preview != dataset_preview)
+            return std::nullopt;
+
+        const auto available = (file.size() - sizeof(DatasetHeader)) / sizeof(DatasetRecord);
+        const auto count = header.record_count != 0 ? std::min<uint64_t>(header.record_count, available) : available;
+
+        const auto records = file.data() + sizeof(DatasetHeader);
+#if __cpp_lib_start_lifetime_as
+        return std::span(std::start_lifetime_as_array<const DatasetRecord>(records, count), count);
+#else
+        // Standard libraries without start_lifetime_as, the 64 byte header keeps the records of a
+        // mapping aligned
+        return std::span(reinterpret_cast<const DatasetRecord*>(records), count);
+#endif
+    }
+}
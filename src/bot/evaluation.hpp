@@ -0,0 +1,238 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "engine/bit_board.hpp"
+#include "engine/board_size.hpp"
+#include "engine/game_board.hpp"
+
+
+namespace tetriz::bot
+{
+    struct BoardFeatures
+    {
+        int aggregate_height = 0;
+        int holes = 0;
+        int bumpiness = 0;
+        int max_height = 0;
+        // Filled to empty changes along the rows and the columns, walls and the floor count as filled
+        int row_transitions = 0;
+        int column_transitions = 0;
+        // Empty cells open from above with both horizontal neighbours filled
+        int wells = 0;
+    };
+
+    // Weights of a linear board score, positive is good
+    struct Weights
+    {
+        float aggregate_height = -0.510066f;
+        float lines = 0.760666f;
+        float holes = -0.35663f;
+        float bumpiness = -0.184483f;
+        float max_height = 0.0f;
+        float row_transitions = 0.0f;
+        float column_transitions = 0.0f;
+        float wells = 0.0f;
+    };
+
+    namespace detail
+    {
+        // Feature counters for one board per lane, Lanes is RowMask, a vector of them or an array to spill into
+        template <typename Lanes>
+        struct LaneFeatures
+        {
+            Lanes aggregate_height{};
+            Lanes holes{};
+            Lanes bumpiness{};
+            Lanes max_height{};
+            Lanes row_transitions{};
+            Lanes column_transitions{};
+            Lanes wells{};
+        };
+
+        // Popcount of each byte, sums of 22 rows of these still fit a byte
+        template <typename Lanes>
+        constexpr auto byte_popcount(Lanes x) -> Lanes
+        {
+            x = Lanes(x - ((x >> 1) & 0x5555));
+            x = Lanes((x & 0x3333) + ((x >> 2) & 0x3333));
+            return Lanes((x + (x >> 4)) & 0x0F0F);
+        }
+
+        // Adds up the two byte counts of each lane
+        template <typename Lanes>
+        constexpr auto fold_bytes(Lanes x) -> Lanes
+        {
+            return Lanes((x & 0x00FF) + (x >> 8));
+        }
+
+        // One in every lane that is not zero
+        template <typename Lanes>
+        constexpr auto nonzero(Lanes x) -> Lanes
+        {
+            return Lanes(Lanes(x | Lanes(Lanes{} - x)) >> 15);
+        }
+
+        // Walks the rows top to bottom once, covered holds the columns whose top block is at or above y
+        template <typename Lanes, typename Load>
+        constexpr auto lane_features(Load&& row_at) -> LaneFeatures<Lanes>
+        {
+            constexpr auto walls = RowMask{1u | 1u << (board_width + 1)};
+            constexpr auto walled_cells = RowMask{(1u << (board_width + 1)) - 1};
+
+            auto result = LaneFeatures<Lanes>{};
+            auto covered = Lanes{};
+            auto above = Lanes{};
+
+            for (auto y = 0uz; y < board_height; ++y)
+            {
+                const auto row = Lanes(row_at(y));
+                const auto walled = Lanes(row << 1 | walls);
+                covered = Lanes(covered | row);
+
+                result.aggregate_height += byte_popcount(covered);
+                result.holes += byte_popcount(Lanes(covered & ~row));
+                result.bumpiness += byte_popcount(Lanes((covered ^ (covered >> 1)) & (full_row >> 1)));
+                result.max_height += nonzero(covered);
+                result.row_transitions += byte_popcount(Lanes((walled ^ (walled >> 1)) & walled_cells));
+                result.column_transitions += byte_popcount(Lanes(row ^ above));
+                result.wells += byte_popcount(Lanes(~covered & walled & (walled >> 2) & full_row));
+
+                above = row;
+            }
+
+            result.column_transitions += byte_popcount(Lanes(above ^ full_row));
+
+            // Byte counts are folded once at the end instead of once per row
+            result.aggregate_height = fold_bytes(result.aggregate_height);
+            result.holes = fold_bytes(result.holes);
+            result.bumpiness = fold_bytes(result.bumpiness);
+            result.row_transitions = fold_bytes(result.row_transitions);
+            result.column_transitions = fold_bytes(result.column_transitions);
+            result.wells = fold_bytes(result.wells);
+
+            return result;
+        }
+
+#if defined(__GNUC__)
+        // The attribute has to sit on a class member typedef, GCC drops it from a dependent alias
+        template <size_t N>
+        struct RowLanes
+        {
+            typedef RowMask type __attribute__((vector_size(N * sizeof(RowMask))));
+        };
+#endif
+
+        template <typename Lanes>
+        constexpr auto lane(const LaneFeatures<Lanes>& features, size_t index) -> BoardFeatures
+        {
+            const auto at = [index](const Lanes& lanes) -> int {
+                if constexpr (std::is_arithmetic_v<Lanes>)
+                    return lanes;
+                else
+                    return lanes[index];
+            };
+
+            return {
+                .aggregate_height = at(features.aggregate_height),
+                .holes = at(features.holes),
+                .bumpiness = at(features.bumpiness),
+                .max_height = at(features.max_height),
+                .row_transitions = at(features.row_transitions),
+                .column_transitions = at(features.column_transitions),
+                .wells = at(features.wells),
+            };
+        }
+    }
+
+    constexpr auto features(const BitBoard& board) -> BoardFeatures
+    {
+        return detail::lane(detail::lane_features<RowMask>([&](size_t y) { return board.row(y); }), 0);
+    }
+
+    // Row masks of N boards stored row-major, row y of every board is contiguous
+    template <size_t N>
+    requires (std::has_single_bit(N))
+    class BoardBatch
+    {
+    public:
+        static constexpr auto size() -> size_t { return N; }
+
+        constexpr void load(size_t index, const BitBoard& board)
+        {
+            for (auto y = 0uz; y < board_height; ++y)
+                rows_[y][index] = board.row(y);
+        }
+
+        // Boards and board views alike, a view counts the piece drawn on it as settled
+        constexpr void load(size_t index, const BoardCells auto& board) { load(index, BitBoard(board)); }
+
+        constexpr auto row(size_t y) const -> std::span<const RowMask, N> { return rows_[y]; }
+
+    private:
+        alignas(N * sizeof(RowMask)) std::array<std::array<RowMask, N>, board_height> rows_{};
+    };
+
+    // Lane by lane fallback, same kernel with plain integers
+    template <size_t N>
+    constexpr auto features_scalar(const BoardBatch<N>& batch) -> std::array<BoardFeatures, N>
+    {
+        auto result = std::array<BoardFeatures, N>{};
+        for (auto index = 0uz; index < N; ++index)
+            result[index] = detail::lane(
+                detail::lane_features<RowMask>([&](size_t y) { return batch.row(y)[index]; }), 0);
+
+        return result;
+    }
+
+    // All N boards at once on GCC/Clang vector extensions, 16 lanes fill a 256 bit register
+    template <size_t N>
+    auto features(const BoardBatch<N>& batch) -> std::array<BoardFeatures, N>
+    {
+#if defined(__GNUC__)
+        using Lanes = typename detail::RowLanes<N>::type;
+        static_assert(sizeof(Lanes) == N * sizeof(RowMask));
+
+        const auto lanes = detail::lane_features<Lanes>([&](size_t y) {
+            auto row = Lanes{};
+            std::memcpy(&row, batch.row(y).data(), sizeof(row));
+            return row;
+        });
+
+        // Reading vector elements one by one is slow, spill all counters to memory first
+        auto spilled = detail::LaneFeatures<std::array<RowMask, N>>{};
+        static_assert(sizeof(spilled) == sizeof(lanes));
+        std::memcpy(&spilled, &lanes, sizeof(spilled));
+
+        auto result = std::array<BoardFeatures, N>{};
+        for (auto index = 0uz; index < N; ++index)
+            result[index] = detail::lane(spilled, index);
+
+        return result;
+#else
+        return features_scalar(batch);
+#endif
+    }
+
+    constexpr auto evaluate(const BoardFeatures& features, const Weights& weights, int lines = 0) -> float
+    {
+        return weights.aggregate_height * features.aggregate_height
+             + weights.lines * lines
+             + weights.holes * features.holes
+             + weights.bumpiness * features.bumpiness
+             + weights.max_height * features.max_height
+             + weights.row_transitions * features.row_transitions
+             + weights.column_transitions * features.column_transitions
+             + weights.wells * features.wells;
+    }
+
+    constexpr auto evaluate(const BitBoard& board, const Weights& weights, int lines = 0) -> float
+    {
+        return evaluate(features(board), weights, lines);
+    }
+}
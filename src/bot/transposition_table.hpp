@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+
+namespace tetriz::bot
+{
+    // Fixed size table of 64 bit values keyed by Game::hash, shared by search threads without locks.
+    // An entry keeps key ^ data next to data, a store torn by a racing one fails the key check and
+    // reads as a miss. Colliding keys simply replace each other.
+    template <typename T>
+    requires std::is_trivially_copyable_v<T> && (sizeof(T) == sizeof(uint64_t))
+    class TranspositionTable
+    {
+        struct Entry
+        {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> data{0};
+        };
+
+    public:
+        // Capacity is rounded up to a power of two
+        explicit TranspositionTable(size_t capacity)
+            : mask_(std::bit_ceil(std::max(capacity, 1uz)) - 1)
+            , entries_(std::make_unique<Entry[]>(mask_ + 1))
+        {}
+
+        void store(uint64_t key, const T& value)
+        {
+            const auto data = std::bit_cast<uint64_t>(value);
+            auto& entry = entries_[key & mask_];
+
+            entry.check.store(key ^ data, std::memory_order_relaxed);
+            entry.data.store(data, std::memory_order_relaxed);
+        }
+
+        auto probe(uint64_t key) const -> std::optional<T>
+        {
+            const auto& entry = entries_[key & mask_];
+            const auto data = entry.data.load(std::memory_order_relaxed);
+
+            if ((entry.check.load(std::memory_order_relaxed) ^ data) != key)
+                return std::nullopt;
+
+            return std::bit_cast<T>(data);
+        }
+
+        // Not safe while other threads use the table
+        void clear()
+        {
+            for (auto index = 0uz; index <= mask_; ++index)
+            {
+                entries_[index].check.store(0, std::memory_order_relaxed);
+                entries_[index].data.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        auto capacity() const -> size_t { return mask_ + 1; }
+
+    private:
+        size_t mask_;
+        std::unique_ptr<Entry[]> entries_;
+    };
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <span>
+
+#include "engine/board_size.hpp"
+#include "engine/game_board.hpp"
+#include "engine/kick_table.hpp"
+#include "engine/piece_masks.hpp"
+#include "engine/tetromino.hpp"
+#include "engine/zobrist.hpp"
+
+
+namespace tetriz
+{
+    // Occupancy-only mirror of the Board, lets collision tests run on whole rows at once
+    template <typename Geometry>
+    class BasicBitBoard
+    {
+
+        // Empty rows around the board so that every row of a piece window can be read
+        static constexpr auto padding = 2uz;
+
+    public:
+        constexpr BasicBitBoard() = default;
+
+        template <BoardCells Board>
+            requires std::same_as<typename Board::Geometry, Geometry>
+        explicit constexpr BasicBitBoard(const Board& board)
+        {
+            for (auto y = 0uz; y < Geometry::height; ++y)
+                for (auto x = 0uz; x < Geometry::width; ++x)
+                    if (is_occupied(board.cell(x, y)))
+                    {
+                        rows_[padding + y] |= static_cast<RowMask>(1u << x);
+                        columns_[x] |= ColumnMask{1} << y;
+                        hash_ ^= zobrist::cell<Geometry>(x, y);
+                    }
+        }
+
+        constexpr auto row(size_t y) const -> RowMask { return rows_[y + padding]; }
+
+        // Zobrist key of the occupied cells, equal boards have equal keys whatever the history
+        constexpr auto hash() const -> uint64_t { return hash_; }
+
+        constexpr auto rows() const -> std::span<const RowMask, Geometry::height>
+        {
+            return std::span(rows_).template subspan<padding, Geometry::height>();
+        }
+
+        // Number of rows in the column that are at or below the topmost block
+        constexpr auto height(size_t x) const -> uint8_t
+        {
+            return Geometry::height - std::countr_zero(columns_[x]);
+        }
+
+        // Number of empty cells in the column starting at row y and going down
+        constexpr auto free_below(size_t x, size_t y) const -> uint8_t
+        {
+            return std::countr_zero(columns_[x] >> y);
+        }
+
+        constexpr auto window(int y) const -> PieceRows
+        {
+            const auto* rows = rows_.data() + padding + y;
+
+            return PieceRows{rows[0]}
+                 | PieceRows{rows[1]} << piece_row_bits
+                 | PieceRows{rows[2]} << 2 * piece_row_bits
+                 | PieceRows{rows[3]} << 3 * piece_row_bits;
+        }
+
+        constexpr void occupy(int y, PieceRows piece)
+        {
+            for (auto row = 0uz; row < 4; ++row)
+            {
+                const auto mask = piece_row(piece, row);
+                rows_[padding + y + row] |= mask;
+
+                for (auto bits = mask; bits; bits &= bits - 1)
+                {
+                    columns_[std::countr_zero(bits)] |= ColumnMask{1} << (y + row);
+                    hash_ ^= zobrist::cell<Geometry>(std::countr_zero(bits), y + row);
+                }
+            }
+        }
+
+        // Bit r of the result is set when the row y + r is full
+        constexpr auto full_rows(int y) const -> uint8_t
+        {
+            constexpr auto lanes = PieceRows{0x0001'0001'0001'0001};
+            constexpr auto low_bits = lanes * 0x7FFF;
+
+            // Full rows turn into zero lanes, adding 0x7FFF carries into bit 15 of every other lane
+            const auto difference = window(y) ^ lanes * Geometry::full_row;
+            const auto nonzero = ((difference & low_bits) + low_bits) | difference;
+            const auto zero = ~nonzero & lanes * 0x8000;
+
+            return static_cast<uint8_t>(
+                  (zero >> 15 & 1)
+                | (zero >> (15 + piece_row_bits - 1) & 2)
+                | (zero >> (15 + 2 * piece_row_bits - 2) & 4)
+                | (zero >> (15 + 3 * piece_row_bits - 3) & 8));
+        }
+
+        // Removes the rows picked by full_rows(y) and drops everything above them in one pass
+        constexpr void clear_rows(int y, uint8_t rows)
+        {
+            const auto bottom = y + (std::bit_width(rows) - 1);
+
+            // Only the rows down to the lowest cleared one change, rekey just those
+            hash_ ^= rows_hash(bottom);
+
+            auto write = padding + bottom;
+            for (auto read = write; read >= padding; --read)
+                if (!is_picked(read - padding, y, rows))
+                    rows_[write--] = rows_[read];
+
+            std::ranges::fill(rows_.begin() + padding, rows_.begin() + write + 1, RowMask{0});
+
+            hash_ ^= rows_hash(bottom);
+
+            for (auto& column : columns_)
+                for (auto bits = rows; bits; bits &= bits - 1)
+                {
+                    const auto row = y + std::countr_zero(bits);
+                    const auto above = (ColumnMask{1} << row) - 1;
+                    column = (column & above) << 1 | (column & ~(above | ColumnMask{1} << row));
+                }
+        }
+
+    private:
+        // Key of the rows from the top down to the row bottom
+        constexpr auto rows_hash(int bottom) const -> uint64_t
+        {
+            auto key = uint64_t{0};
+            for (auto y = 0; y <= bottom; ++y)
+                key ^= zobrist::row<Geometry>(y, rows_[padding + y]);
+
+            return key;
+        }
+
+        static constexpr auto is_picked(int row, int y, uint8_t rows) -> bool
+        {
+            return row >= y && row < y + 4 && (rows >> (row - y) & 1);
+        }
+
+        // Bit y of a column mask is the row y, bit Geometry::height is the floor
+        using ColumnMask = uint32_t;
+
+        static_assert(Geometry::height < std::numeric_limits<ColumnMask>::digits);
+
+        std::array<RowMask, padding + Geometry::height + padding> rows_{};
+        std::array<ColumnMask, Geometry::width> columns_ = []{
+            auto columns = std::array<ColumnMask, Geometry::width>{};
+            std::ranges::fill(columns, ColumnMask{1} << Geometry::height);
+            return columns;
+        }();
+        uint64_t hash_ = 0;
+    };
+
+    using BitBoard = BasicBitBoard<StandardGeometry>;
+
+    template <typename Geometry>
+    constexpr auto fits(const BasicBitBoard<Geometry>& board, const Tetromino& tetromino) -> bool
+    {
+        const auto& masks = piece_masks_of<Geometry>(tetromino);
+        const auto [x, y] = tetromino.coordinates;
+
+        return masks.contains(x, y) && (board.window(y) & masks.at(x)) == 0;
+    }
+
+    // Number of rows the tetromino falls before it rests on the stack or the floor
+    template <typename Geometry>
+    constexpr auto drop_distance(const BasicBitBoard<Geometry>& board, const Tetromino& tetromino) -> uint8_t
+    {
+        const auto& masks = piece_masks_of<Geometry>(tetromino);
+        const auto [x, y] = tetromino.coordinates;
+
+        auto distance = static_cast<uint8_t>(Geometry::height);
+        for (const auto [column, bottom] : masks.bottom | std::views::enumerate)
+            if (bottom >= 0)
+                distance = std::min(distance, board.free_below(x + column, y + bottom + 1));
+
+        return distance;
+    }
+
+    struct KickedRotation
+    {
+        Tetromino tetromino;
+        uint8_t kick;
+    };
+
+    // Rotates to the next rotation state using the first kick of the policy that fits
+    template <typename Kicks = SrsKicks, typename Geometry>
+    constexpr auto rotate(const BasicBitBoard<Geometry>& board, Tetromino tetromino) -> std::optional<KickedRotation>
+    {
+        tetromino.rotation = next_left(tetromino.rotation);
+
+        for (const auto [kick, offset] : Kicks::kicks(tetromino.shape, tetromino.rotation) | std::views::enumerate)
+        {
+            auto kicked = tetromino;
+            kicked.coordinates.x += offset.first;
+            kicked.coordinates.y += offset.second;
+
+            if (fits(board, kicked))
+                return KickedRotation{ kicked, static_cast<uint8_t>(kick) };
+        }
+
+        return std::nullopt;
+    }
+
+    template <typename Geometry>
+    constexpr void project_on_board(BasicBitBoard<Geometry>& board, tetriz::Tetromino tetromino)
+    {
+        const auto [curr_x, curr_y] = tetromino.coordinates;
+        board.occupy(curr_y, piece_masks_of<Geometry>(tetromino).at(curr_x));
+    }
+}
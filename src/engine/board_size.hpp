@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+namespace tetriz
+{
+    // One bit per cell, bit x of a row mask is the column x
+    using RowMask = uint16_t;
+
+    template <size_t Width, size_t Height>
+    struct BoardGeometry
+    {
+        static constexpr auto width = Width;
+        static constexpr auto height = Height;
+        static constexpr auto full_row = static_cast<RowMask>((1u << Width) - 1);
+
+        // Pieces have to fit, column masks keep a floor bit above the last row
+        static_assert(Width >= 4 && Width <= std::numeric_limits<RowMask>::digits);
+        static_assert(Height >= 4 && Height < std::numeric_limits<uint32_t>::digits);
+    };
+
+    using StandardGeometry = BoardGeometry<10, 22>;
+
+    static constexpr auto board_width = static_cast<unsigned>(StandardGeometry::width);
+    static constexpr auto board_height = static_cast<unsigned>(StandardGeometry::height);
+
+    constexpr inline auto full_row = StandardGeometry::full_row;
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+#include "magic_enum/magic_enum_containers.hpp"
+
+#include "engine/bit_board.hpp"
+#include "engine/game.hpp"
+#include "engine/move.hpp"
+#include "engine/piece_masks.hpp"
+#include "engine/rules.hpp"
+
+
+namespace tetriz
+{
+    namespace detail
+    {
+        // Shortest paths from one start to every piece state, moves are Left, Right, Down and Rotate
+        template <typename Rules>
+        struct FinesseTree
+        {
+            using States = PieceStates<typename Rules::Geometry>;
+
+            static constexpr auto unreached = uint16_t{UINT16_MAX};
+
+            std::array<uint16_t, States::count> distance{};
+            std::array<uint16_t, States::count> parent{};
+            std::array<Move, States::count> move{};
+            std::array<Tetromino, States::count> state{};
+
+            // Visits states in order of distance and stops as soon as done(state) holds,
+            // returns that state or nothing when the search runs out
+            template <typename Done>
+            constexpr auto search(const BasicBitBoard<typename Rules::Geometry>& board, const Tetromino& start,
+                                  Done&& done) -> std::optional<Tetromino>
+            {
+                std::ranges::fill(distance, unreached);
+
+                if (!fits(board, start))
+                    return std::nullopt;
+
+                auto queue = std::array<uint16_t, States::count>{};
+                auto head = 0uz;
+                auto tail = 0uz;
+
+                const auto visit = [&](const Tetromino& tetromino, size_t from, Move by) {
+                    const auto index = States::index(tetromino);
+                    if (distance[index] != unreached)
+                        return;
+
+                    distance[index] = distance[from] + 1;
+                    parent[index] = static_cast<uint16_t>(from);
+                    move[index] = by;
+                    state[index] = tetromino;
+                    queue[tail++] = static_cast<uint16_t>(index);
+                };
+
+                const auto shifted = [&](Tetromino tetromino, int x, int y, size_t from, Move by) {
+                    tetromino.coordinates.x += x;
+                    tetromino.coordinates.y += y;
+
+                    if (fits(board, tetromino))
+                        visit(tetromino, from, by);
+                };
+
+                const auto start_index = States::index(start);
+                distance[start_index] = 0;
+                state[start_index] = start;
+                queue[tail++] = static_cast<uint16_t>(start_index);
+
+                while (head != tail)
+                {
+                    const auto index = queue[head++];
+                    const auto current = state[index];
+
+                    if (done(current))
+                        return current;
+
+                    shifted(current, -1, 0, index, Move::Left);
+                    shifted(current, 1, 0, index, Move::Right);
+                    shifted(current, 0, 1, index, Move::Down);
+
+                    if (const auto rotation = rotate<typename Rules::Kicks>(board, current); rotation)
+                        visit(rotation->tetromino, index, Move::Rotate);
+                }
+
+                return std::nullopt;
+            }
+
+            // Moves from the start to the state, in order
+            constexpr auto path(const Tetromino& tetromino) const -> std::vector<Move>
+            {
+                auto index = States::index(tetromino);
+                auto moves = std::vector<Move>(distance[index]);
+
+                for (auto& slot : moves | std::views::reverse)
+                {
+                    slot = move[index];
+                    index = parent[index];
+                }
+
+                return moves;
+            }
+        };
+
+        constexpr auto same_state(const Tetromino& lhs, const Tetromino& rhs) -> bool
+        {
+            return lhs.rotation == rhs.rotation
+                && lhs.coordinates.x == rhs.coordinates.x
+                && lhs.coordinates.y == rhs.coordinates.y;
+        }
+
+        // Open board paths are short, longer ones are left to the search
+        constexpr inline auto max_open_path = 15uz;
+
+        struct OpenPath
+        {
+            std::array<Move, max_open_path> moves{};
+            uint8_t size = 0;
+            // Row the piece is in when it is dropped
+            int8_t y = 0;
+            bool reachable = false;
+        };
+
+        // For every shape, rotation and column the shortest way from the spawn to a state
+        // above it on an empty board, the hard drop that follows is implied
+        template <typename Rules>
+        constexpr auto make_open_board_finesse()
+        {
+            using Geometry = typename Rules::Geometry;
+
+            auto table = magic_enum::containers::array<TetrominoShape,
+                         magic_enum::containers::array<TetrominoRotation,
+                         std::array<OpenPath, Geometry::width + PieceStates<Geometry>::margin>>>{};
+
+            const auto board = BasicBitBoard<Geometry>{};
+            auto tree = FinesseTree<Rules>{};
+
+            for (const auto shape : magic_enum::enum_values<TetrominoShape>())
+            {
+                const auto start = Rules::SpawnPolicy::spawn(board, shape).tetromino;
+                tree.search(board, start, [](const auto&) { return false; });
+
+                // Keep the nearest state of every column and rotation
+                for (auto index = 0uz; index < tree.distance.size(); ++index)
+                {
+                    if (tree.distance[index] == tree.unreached)
+                        continue;
+
+                    const auto& state = tree.state[index];
+                    auto& entry = table[shape][state.rotation][state.coordinates.x + PieceStates<Geometry>::margin];
+
+                    if (tree.distance[index] > max_open_path || (entry.reachable && entry.size <= tree.distance[index]))
+                        continue;
+
+                    const auto moves = tree.path(state);
+                    std::ranges::copy(moves, entry.moves.begin());
+                    entry.size = static_cast<uint8_t>(moves.size());
+                    entry.y = state.coordinates.y;
+                    entry.reachable = true;
+                }
+            }
+
+            return table;
+        }
+    }
+
+    // Built at compile time for every rule set that asks for it
+    template <typename Rules>
+    constexpr inline auto open_board_finesse = detail::make_open_board_finesse<Rules>();
+
+    // Shortest input sequence that takes the piece from start to lock exactly at target, the last
+    // move is the Drop that locks it. Gravity is not part of the search.
+    template <typename Rules = StandardRules>
+    constexpr auto finesse(const BasicBitBoard<typename Rules::Geometry>& board, const Tetromino& start,
+                           const Tetromino& target) -> std::optional<std::vector<Move>>
+    {
+        using Geometry = typename Rules::Geometry;
+
+        if (!fits(board, target) || drop_distance(board, target) != 0 || target.shape != start.shape)
+            return std::nullopt;
+
+        // A move lowers the piece by at most two rows, a kick test included, so with enough empty
+        // rows under the spawn no sequence up to the table length can touch the stack and the
+        // open board answer is the shortest one here too
+        const auto spawn = Rules::SpawnPolicy::spawn(BasicBitBoard<Geometry>{}, start.shape).tetromino;
+        const auto& open = open_board_finesse<Rules>[target.shape][target.rotation]
+                                                    [target.coordinates.x + PieceStates<Geometry>::margin];
+
+        if (open.reachable && detail::same_state(start, spawn))
+        {
+            auto top = static_cast<int>(Geometry::height);
+            for (auto x = 0uz; x < Geometry::width; ++x)
+                top = std::min(top, static_cast<int>(Geometry::height - board.height(x)));
+
+            auto dropped = target;
+            dropped.coordinates.y = open.y;
+
+            if (top > start.coordinates.y + 3 + 2 * open.size
+                && dropped.coordinates.y + drop_distance(board, dropped) == target.coordinates.y)
+            {
+                auto moves = std::vector<Move>(open.moves.begin(), open.moves.begin() + open.size);
+                moves.push_back(Move::Drop);
+                return moves;
+            }
+        }
+
+        auto tree = detail::FinesseTree<Rules>{};
+        const auto last = tree.search(board, start, [&](const Tetromino& state) {
+            return state.rotation == target.rotation
+                && state.coordinates.x == target.coordinates.x
+                && state.coordinates.y + drop_distance(board, state) == target.coordinates.y;
+        });
+
+        if (!last)
+            return std::nullopt;
+
+        auto moves = tree.path(*last);
+        moves.push_back(Move::Drop);
+        return moves;
+    }
+
+    template <typename Rules>
+    constexpr auto finesse(const BasicGame<Rules>& game, const Tetromino& target) -> std::optional<std::vector<Move>>
+    {
+        return finesse<Rules>(game.occupancy(), game.current(), target);
+    }
+}
@@ -1,11 +1,20 @@
 #pragma once
 
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "engine/bit_board.hpp"
 #include "engine/bounding_box.hpp"
 #include "engine/game_board.hpp"
+#include "engine/game_event.hpp"
 #include "engine/kick_table.hpp"
+#include "engine/move.hpp"
 #include "engine/offsets.hpp"
+#include "engine/rules.hpp"
 #include "engine/tetromino.hpp"
 #include "engine/tetromino_bag.hpp"
+#include "engine/zobrist.hpp"
 
 
 namespace tetriz
@@ -20,15 +29,49 @@ namespace tetriz
     constexpr inline auto x_shift = magic_enum::containers::array<Direction, int8_t>{ -1, 1, 0 };
     constexpr inline auto y_shift = magic_enum::containers::array<Direction, int8_t>{ 0, 0, 1 };
 
-    class Game
+    // Everything needed to rewind a Game, the occupancy mirror is kept alongside the board
+    // so a restore is a plain copy and nothing is rescanned
+    template <typename Rules>
+    struct BasicGameSnapshot
     {
+        BasicBoard<typename Rules::Geometry> board;
+        BasicBitBoard<typename Rules::Geometry> occupancy;
+        BasicTetrominoBag<typename Rules::Randomizer> bag;
+        Tetromino current;
+        std::optional<TetrominoShape> swapped;
+        uint16_t score;
+        bool just_swapped;
+        bool finished;
+    };
+
+    using GameSnapshot = BasicGameSnapshot<StandardRules>;
+
+    static_assert(std::is_trivially_copyable_v<GameSnapshot>);
+
+    template <typename Rules>
+    class BasicGame
+    {
+        using Geometry = typename Rules::Geometry;
+
     public:
-        constexpr Game(uint32_t seed)
+        using Board = BasicBoard<Geometry>;
+        using BoardView = BasicBoardView<Geometry>;
+        using BitBoard = BasicBitBoard<Geometry>;
+        using TetrominoBag = BasicTetrominoBag<typename Rules::Randomizer>;
+        using GameSnapshot = BasicGameSnapshot<Rules>;
+
+        constexpr BasicGame(uint32_t seed)
             : bag_(seed)
         {
             spawn(bag_.poll());
         }
 
+        explicit constexpr BasicGame(const GameSnapshot& snapshot)
+            : bag_(snapshot.bag)
+        {
+            restore(snapshot);
+        }
+
         constexpr void move(Direction direction)
         {
             const auto x_shift = tetriz::x_shift[direction];
@@ -38,6 +81,7 @@ namespace tetriz
             {
                 current_.coordinates.x += x_shift;
                 current_.coordinates.y += y_shift;
+                emit({ .tetromino = current_, .type = GameEventType::Moved });
             }
             else if (direction == Direction::Down)
             {
@@ -52,27 +96,24 @@ namespace tetriz
 
         constexpr void drop()
         {
-            while (is_empty(0, 1))
-                current_.coordinates.y += 1;
-
+            current_.coordinates.y += drop_distance();
             lock();
         }
 
         constexpr void rotate()
         {
-            current_.rotation = next_left(current_.rotation);
-
-            for (auto [x_offset, y_offset] : kick_offsets(current_.shape, current_.rotation))
+            if (const auto rotation = tetriz::rotate<typename Rules::Kicks>(occupancy_, current_); rotation)
             {
-                if (is_empty(x_offset, y_offset))
-                {
-                    current_.coordinates.x += x_offset;
-                    current_.coordinates.y += y_offset;
-                    return;
-                }
+                current_ = rotation->tetromino;
+                emit({ .tetromino = current_, .type = GameEventType::Rotated, .kick = rotation->kick });
             }
+        }
 
-            current_.rotation = next_right(current_.rotation);
+        // Locks the current piece at a resting position, e.g. one returned by find_placements
+        constexpr void place(const Tetromino& placement)
+        {
+            current_ = placement;
+            lock();
         }
 
         constexpr void swap()
@@ -87,34 +128,117 @@ namespace tetriz
             spawn(*swapped_);
             swapped_ = original_shape;
             just_swapped_ = true;
+            emit({ .tetromino = { .shape = original_shape }, .type = GameEventType::Swapped });
+        }
+
+        constexpr void apply(Move move)
+        {
+            switch (move)
+            {
+                case Move::Left:   return this->move(Direction::Left);
+                case Move::Right:  return this->move(Direction::Right);
+                case Move::Down:   return this->move(Direction::Down);
+                case Move::Drop:   return drop();
+                case Move::Rotate: return rotate();
+                case Move::Swap:   return swap();
+            }
+        }
+
+        constexpr void apply(std::span<const Move> moves)
+        {
+            for (const auto move : moves)
+                apply(move);
+        }
+
+        // on_input(move, game) runs after every applied move
+        template <typename Callback>
+        constexpr void apply(std::span<const Move> moves, Callback&& on_input)
+        {
+            for (const auto move : moves)
+            {
+                apply(move);
+                on_input(move, std::as_const(*this));
+            }
+        }
+
+        constexpr auto snapshot() const -> GameSnapshot
+        {
+            return {
+                .board = board_,
+                .occupancy = occupancy_,
+                .bag = bag_,
+                .current = current_,
+                .swapped = swapped_,
+                .score = score_,
+                .just_swapped = just_swapped_,
+                .finished = finished_
+            };
+        }
+
+        constexpr void restore(const GameSnapshot& snapshot)
+        {
+            board_ = snapshot.board;
+            occupancy_ = snapshot.occupancy;
+            bag_ = snapshot.bag;
+            current_ = snapshot.current;
+            swapped_ = snapshot.swapped;
+            score_ = snapshot.score;
+            just_swapped_ = snapshot.just_swapped;
+            finished_ = snapshot.finished;
+        }
+
+        // Events are appended to the buffer until it is replaced or reset with nullptr, copies of the game do not inherit it
+        constexpr void set_event_buffer(GameEventBuffer* events)
+        {
+            events_.buffer = events;
         }
 
         constexpr auto finished() const -> bool { return finished_; }
         constexpr auto board() const -> const Board& { return board_; }
+        // Board with the falling piece drawn on it
+        constexpr auto view() const -> BoardView { return BoardView(board_, current_); }
+        constexpr auto occupancy() const -> const BitBoard& { return occupancy_; }
         constexpr auto current() const -> const Tetromino& { return current_; }
         constexpr auto score() const -> uint16_t { return score_; }
         constexpr auto bag() const -> const TetrominoBag& { return bag_; }
         constexpr auto swapped() const -> const std::optional<TetrominoShape>& { return swapped_; }
+        constexpr auto just_swapped() const -> bool { return just_swapped_; }
 
-    private:
-        constexpr auto is_empty(int x_offset, int y_offset) const -> bool
+        // Zobrist key of everything that decides how the game goes on, the score is left out so that
+        // a position reached through different orders hashes the same. Board and bag keep their keys
+        // up to date as they change, the rest is a few table lookups.
+        constexpr auto hash() const -> uint64_t
         {
-            const auto bb_size = bounding_box_sizes[current_.shape];
-            const auto offsets = tetriz::offsets[current_.shape][current_.rotation];
-            const auto [curr_x, curr_y] = current_.coordinates;
+            return occupancy_.hash()
+                 ^ bag_.hash()
+                 ^ zobrist::piece<Geometry>(current_)
+                 ^ zobrist::swapped(swapped_)
+                 ^ (just_swapped_ ? zobrist::just_swapped : 0)
+                 ^ (finished_ ? zobrist::finished : 0);
+        }
+
+        constexpr auto drop_distance() const -> uint8_t { return drop_distance(current_); }
+        constexpr auto ghost() const -> Tetromino { return ghost(current_); }
+
+        constexpr auto drop_distance(const Tetromino& tetromino) const -> uint8_t
+        {
+            return tetriz::drop_distance(occupancy_, tetromino);
+        }
 
-            if (curr_x + x_offset + offsets[Side::Left] < 0
-             || curr_x + x_offset - offsets[Side::Right] + bb_size > board_width
-             || curr_y + y_offset - offsets[Side::Bottom] + bb_size > board_height)
-                return false;
+        constexpr auto ghost(Tetromino tetromino) const -> Tetromino
+        {
+            tetromino.coordinates.y += drop_distance(tetromino);
+            return tetromino;
+        }
 
-            const auto bounding_box = bounding_boxes[current_.shape][current_.rotation];
-            for (auto y = offsets[Side::Top]; y < bb_size - offsets[Side::Bottom]; ++y)
-                for (auto x = offsets[Side::Left]; x < bb_size - offsets[Side::Right]; ++x)
-                    if (bounding_box[y][x] && is_occupied(board_[y + curr_y + y_offset][x + curr_x + x_offset]))
-                        return false;
+    private:
+        constexpr auto is_empty(int x_offset, int y_offset) const -> bool
+        {
+            auto moved = current_;
+            moved.coordinates.x += x_offset;
+            moved.coordinates.y += y_offset;
 
-            return true;
+            return fits(occupancy_, moved);
         }
 
         constexpr void try_lock()
@@ -123,51 +247,47 @@ namespace tetriz
                 lock();
         }
 
+        constexpr void emit(const GameEvent& event)
+        {
+            if (events_.buffer)
+                events_.buffer->push(event);
+        }
+
         constexpr void lock()
         {
+            emit({ .tetromino = current_, .type = GameEventType::Locked });
             project_on_board(board_, current_);
-            clear_lines();
+            clear_lines(settle(occupancy_, current_));
             spawn(bag_.poll());
             just_swapped_ = false;
         }
 
         constexpr void spawn(TetrominoShape shape)
         {
-            current_ = Tetromino{
-                .shape = shape,
-                .rotation = TetrominoRotation::Base,
-                .coordinates = { 3, 1 }
-            };
-
-            if (is_empty(0, 0))
-                return;
+            const auto [tetromino, topped_out] = Rules::SpawnPolicy::spawn(occupancy_, shape);
+            current_ = tetromino;
 
-            if (is_empty(0, -1))
+            if (topped_out)
             {
-                --current_.coordinates.y;
+                finished_ = true;
+                emit({ .tetromino = current_, .type = GameEventType::ToppedOut });
                 return;
             }
 
-            finished_ = true;
+            emit({ .tetromino = current_, .type = GameEventType::Spawned });
         }
 
-        constexpr void clear_lines()
+        // Rows were already cleared from the occupancy by settle, mirrors that on the board
+        constexpr void clear_lines(uint8_t rows)
         {
-            const auto row_begin = current_.coordinates.y + offsets[current_.shape][current_.rotation][Side::Top];
-            const auto row_count = std::min(
-                    bounding_box_sizes[current_.shape] - offsets[current_.shape][current_.rotation][Side::Bottom],
-                    board_.size() - row_begin);
+            const auto y = current_.coordinates.y;
 
-            for (auto row : std::views::iota(row_begin) | std::views::take(row_count))
-                if (std::ranges::all_of(board_[row], is_occupied))
-                    clear_line(row);
-        }
+            if (!rows)
+                return;
 
-        constexpr void clear_line(uint8_t row)
-        {
-            std::ranges::copy_backward(board_ | std::views::take(row), board_.begin() + row + 1);
-            std::ranges::fill(board_[0], Block::Void);
-            ++score_;
+            board_.clear_rows(y, rows);
+            score_ += std::popcount(rows);
+            emit({ .type = GameEventType::Cleared, .rows = y < 0 ? uint32_t{rows} >> -y : uint32_t{rows} << y });
         }
 
         Tetromino current_{};
@@ -177,5 +297,20 @@ namespace tetriz
         bool finished_ = false;
         uint16_t score_ = 0;
         Board board_{};
+        BitBoard occupancy_{};
+
+        struct EventSink
+        {
+            constexpr EventSink() = default;
+            constexpr EventSink(const EventSink&) {}
+            constexpr auto operator=(const EventSink&) -> EventSink& { return *this; }
+
+            GameEventBuffer* buffer = nullptr;
+        } events_;
     };
+
+    using Game = BasicGame<StandardRules>;
+
+    // Rooms and simulations keep thousands of games around, keep them within a few cache lines
+    static_assert(sizeof(Game) <= 512);
 }
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "magic_enum/magic_enum_containers.hpp"
+
+#include "engine/bit_board.hpp"
+#include "engine/move.hpp"
+#include "engine/rules.hpp"
+#include "engine/tetromino.hpp"
+#include "engine/tetromino_bag.hpp"
+
+
+namespace tetriz
+{
+    // N games stepped in lockstep, one move per game per step, with the same rules as Game.
+    // Every field lives in its own array and only the occupancy is kept, so a step walks
+    // a few dense arrays instead of N full games. Large batches belong on the heap.
+    template <size_t N, typename Rules = StandardRules>
+    class GameBatch
+    {
+        using BitBoard = BasicBitBoard<typename Rules::Geometry>;
+        using TetrominoBag = BasicTetrominoBag<typename Rules::Randomizer>;
+
+    public:
+        explicit constexpr GameBatch(std::span<const uint32_t, N> seeds)
+            : bags_(make_bags(seeds, std::make_index_sequence<N>{}))
+        {
+            for (auto game = 0uz; game < N; ++game)
+                spawn(game, bags_[game].poll());
+        }
+
+        static constexpr auto size() -> size_t { return N; }
+
+        // Starts the game over as if it was constructed with the seed
+        constexpr void reset(size_t game, uint32_t seed)
+        {
+            boards_[game] = BitBoard{};
+            scores_[game] = 0;
+            bags_[game] = TetrominoBag(seed);
+            has_swapped_[game] = false;
+            just_swapped_[game] = false;
+            finished_[game] = false;
+            spawn(game, bags_[game].poll());
+        }
+
+        // moves[i] goes to the game i, same as Game::apply(moves[i]) on each of them
+        constexpr void apply(std::span<const Move, N> moves)
+        {
+            // Games are grouped by move first, every group then runs without a mispredicted switch
+            auto counts = magic_enum::containers::array<Move, uint32_t>{};
+            for (const auto move : moves)
+                ++counts[move];
+
+            auto begins = magic_enum::containers::array<Move, uint32_t>{};
+            std::exclusive_scan(counts.begin(), counts.end(), begins.begin(), uint32_t{0});
+
+            auto cursors = begins;
+            for (auto game = 0uz; game < N; ++game)
+                order_[cursors[moves[game]]++] = static_cast<uint32_t>(game);
+
+            for (const auto move : magic_enum::enum_values<Move>())
+            {
+                const auto group = std::span(order_).subspan(begins[move], counts[move]);
+                switch (move)
+                {
+                    case Move::Left:   for (const auto game : group) shift(game, -1); break;
+                    case Move::Right:  for (const auto game : group) shift(game, 1); break;
+                    case Move::Down:   for (const auto game : group) fall(game); break;
+                    case Move::Drop:   for (const auto game : group) drop(game); break;
+                    case Move::Rotate: for (const auto game : group) rotate(game); break;
+                    case Move::Swap:   for (const auto game : group) swap(game); break;
+                }
+            }
+        }
+
+        constexpr void apply(size_t game, Move move)
+        {
+            switch (move)
+            {
+                case Move::Left:   return shift(game, -1);
+                case Move::Right:  return shift(game, 1);
+                case Move::Down:   return fall(game);
+                case Move::Drop:   return drop(game);
+                case Move::Rotate: return rotate(game);
+                case Move::Swap:   return swap(game);
+            }
+        }
+
+        // Same as Game::place, locks the current piece of the game at a resting position
+        constexpr void place(size_t game, const Tetromino& placement)
+        {
+            current_[game] = placement;
+            lock(game);
+        }
+
+        constexpr auto finished(size_t game) const -> bool { return finished_[game]; }
+        constexpr auto occupancy(size_t game) const -> const BitBoard& { return boards_[game]; }
+        constexpr auto current(size_t game) const -> const Tetromino& { return current_[game]; }
+        constexpr auto score(size_t game) const -> uint16_t { return scores_[game]; }
+        constexpr auto bag(size_t game) const -> const TetrominoBag& { return bags_[game]; }
+        constexpr auto just_swapped(size_t game) const -> bool { return just_swapped_[game]; }
+
+        constexpr auto swapped(size_t game) const -> std::optional<TetrominoShape>
+        {
+            return has_swapped_[game] ? std::optional(swapped_[game]) : std::nullopt;
+        }
+
+    private:
+        template <size_t... Index>
+        static constexpr auto make_bags(std::span<const uint32_t, N> seeds, std::index_sequence<Index...>)
+        {
+            return std::array<TetrominoBag, N>{ TetrominoBag(seeds[Index])... };
+        }
+
+        constexpr void shift(size_t game, int x)
+        {
+            auto moved = current_[game];
+            moved.coordinates.x += x;
+
+            if (fits(boards_[game], moved))
+                current_[game] = moved;
+        }
+
+        constexpr void fall(size_t game)
+        {
+            auto moved = current_[game];
+            ++moved.coordinates.y;
+
+            if (fits(boards_[game], moved))
+                current_[game] = moved;
+            else
+                lock(game);
+        }
+
+        constexpr void drop(size_t game)
+        {
+            current_[game].coordinates.y += drop_distance(boards_[game], current_[game]);
+            lock(game);
+        }
+
+        constexpr void rotate(size_t game)
+        {
+            if (const auto rotation = tetriz::rotate<typename Rules::Kicks>(boards_[game], current_[game]); rotation)
+                current_[game] = rotation->tetromino;
+        }
+
+        constexpr void swap(size_t game)
+        {
+            if (just_swapped_[game])
+                return;
+
+            if (!has_swapped_[game])
+            {
+                swapped_[game] = bags_[game].poll();
+                has_swapped_[game] = true;
+            }
+
+            const auto original_shape = current_[game].shape;
+            spawn(game, swapped_[game]);
+            swapped_[game] = original_shape;
+            just_swapped_[game] = true;
+        }
+
+        constexpr void lock(size_t game)
+        {
+            scores_[game] += std::popcount(settle(boards_[game], current_[game]));
+            spawn(game, bags_[game].poll());
+            just_swapped_[game] = false;
+        }
+
+        constexpr void spawn(size_t game, TetrominoShape shape)
+        {
+            const auto [tetromino, topped_out] = Rules::SpawnPolicy::spawn(boards_[game], shape);
+            current_[game] = tetromino;
+
+            if (topped_out)
+                finished_[game] = true;
+        }
+
+        std::array<BitBoard, N> boards_{};
+        std::array<Tetromino, N> current_{};
+        std::array<TetrominoShape, N> swapped_{};
+        std::array<uint16_t, N> scores_{};
+        std::array<TetrominoBag, N> bags_;
+        std::bitset<N> has_swapped_{};
+        std::bitset<N> just_swapped_{};
+        std::bitset<N> finished_{};
+        std::array<uint32_t, N> order_{};
+    };
+}
@@ -1,18 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <concepts>
 #include <cstdint>
+#include <numeric>
 #include <ranges>
 
-#include "engine/bounding_box.hpp"
+#include "engine/board_size.hpp"
+#include "engine/piece_masks.hpp"
 #include "engine/tetromino.hpp"
 
 
 namespace tetriz
 {
-    static constexpr auto board_width = 10u;
-    static constexpr auto board_height = 22u;
-
     enum class Block : uint8_t
     {
         Void,
@@ -30,23 +32,156 @@ namespace tetriz
         return block != Block::Void;
     }
 
-    using Board = std::array<std::array<Block, board_width>, board_height>;
+    template <typename Geometry>
+    using BasicBoardRow = std::array<Block, Geometry::width>;
+
+    // The rows top to bottom, how a board is written out
+    template <typename Geometry>
+    using BasicBoardRows = std::array<BasicBoardRow<Geometry>, Geometry::height>;
+
+    // Rows are reached through an index table, so clearing rows only moves
+    // the indices instead of copying the rows around them
+    template <typename Geometry_>
+    class BasicBoard
+    {
+    public:
+        using Geometry = Geometry_;
+        using BoardRow = BasicBoardRow<Geometry>;
+
+        constexpr BasicBoard()
+        {
+            std::ranges::iota(order_, uint8_t{0});
+        }
+
+        constexpr explicit BasicBoard(const BasicBoardRows<Geometry>& rows)
+            : rows_(rows)
+        {
+            std::ranges::iota(order_, uint8_t{0});
+        }
+
+        static constexpr auto size() -> size_t { return Geometry::height; }
+
+        constexpr auto operator[](size_t y) -> BoardRow& { return rows_[order_[y]]; }
+        constexpr auto operator[](size_t y) const -> const BoardRow& { return rows_[order_[y]]; }
+
+        constexpr auto cell(size_t x, size_t y) const -> Block { return rows_[order_[y]][x]; }
+
+        // The rows in board order, independent of how they are stored
+        constexpr auto rows() const -> BasicBoardRows<Geometry>
+        {
+            auto rows = BasicBoardRows<Geometry>{};
+            for (auto y = 0uz; y < size(); ++y)
+                rows[y] = (*this)[y];
+
+            return rows;
+        }
+
+        // Removes the rows y + r for every bit r set in rows, everything above them drops down
+        constexpr void clear_rows(int y, uint8_t rows)
+        {
+            auto cleared = std::array<uint8_t, 4>{};
+            auto cleared_count = 0uz;
+
+            auto write = y + (std::bit_width(rows) - 1);
+            for (auto read = write; read >= 0; --read)
+            {
+                if (read >= y && (rows >> (read - y) & 1))
+                    cleared[cleared_count++] = order_[read];
+                else
+                    order_[write--] = order_[read];
+            }
+
+            for (const auto row : cleared | std::views::take(cleared_count))
+            {
+                std::ranges::fill(rows_[row], Block::Void);
+                order_[write--] = row;
+            }
+        }
+
+    private:
+        BasicBoardRows<Geometry> rows_{};
+        std::array<uint8_t, Geometry::height> order_{};
+    };
+
+    using BoardRow = BasicBoardRow<StandardGeometry>;
+    using BoardRows = BasicBoardRows<StandardGeometry>;
+    using Board = BasicBoard<StandardGeometry>;
 
-    constexpr void project_on_board(tetriz::Board& board, tetriz::Tetromino tetromino)
+    template <typename Geometry>
+    constexpr void project_on_board(BasicBoard<Geometry>& board, tetriz::Tetromino tetromino)
     {
         const auto [curr_x, curr_y] = tetromino.coordinates;
-        const auto bounding_box = tetriz::bounding_boxes[tetromino.shape][tetromino.rotation];
+        const auto rows = piece_masks_of<Geometry>(tetromino).at(curr_x);
 
-        for (const auto& [y, row] : bounding_box | std::views::enumerate)
-            for (const auto [x, block] : row | std::views::enumerate)
-                if (block)
-                    board[curr_y + y][curr_x + x] = static_cast<Block>(tetromino.shape);
+        for (auto y = 0uz; y < 4; ++y)
+            for (auto mask = piece_row(rows, y); mask; mask &= mask - 1)
+                board[curr_y + y][std::countr_zero(mask)] = static_cast<Block>(tetromino.shape);
     }
 
-    constexpr auto project_on_board(const tetriz::Board& board, tetriz::Tetromino tetromino) -> Board
+    // Read-only board with a piece drawn over it, cells of the piece are answered from its
+    // masks so nothing is copied. The board must outlive the view.
+    template <typename Geometry_>
+    class BasicBoardView
     {
-        auto board_new = board;
-        project_on_board(board_new, tetromino);
-        return board_new;
-    }
+    public:
+        using Geometry = Geometry_;
+
+        // A board row with the piece's blocks of that row on top
+        class Row
+        {
+        public:
+            constexpr Row(const BasicBoardRow<Geometry>& cells, RowMask piece, Block block)
+                : cells_(&cells), piece_(piece), block_(block)
+            {}
+
+            static constexpr auto size() -> size_t { return Geometry::width; }
+
+            constexpr auto operator[](size_t x) const -> Block
+            {
+                return piece_ >> x & 1 ? block_ : (*cells_)[x];
+            }
+
+        private:
+            const BasicBoardRow<Geometry>* cells_;
+            RowMask piece_;
+            Block block_;
+        };
+
+        constexpr BasicBoardView(const BasicBoard<Geometry>& board, const Tetromino& tetromino)
+            : board_(&board)
+            , piece_(piece_masks_of<Geometry>(tetromino).at(tetromino.coordinates.x))
+            , y_(tetromino.coordinates.y)
+            , block_(static_cast<Block>(tetromino.shape))
+        {}
+
+        static constexpr auto size() -> size_t { return Geometry::height; }
+
+        // Scans should go row by row, the piece is looked up once per row
+        constexpr auto operator[](size_t y) const -> Row
+        {
+            const auto row = static_cast<int>(y) - y_;
+            const auto piece = row >= 0 && row < 4 ? piece_row(piece_, row) : RowMask{0};
+
+            return Row((*board_)[y], piece, block_);
+        }
+
+        constexpr auto cell(size_t x, size_t y) const -> Block { return (*this)[y][x]; }
+
+        constexpr auto board() const -> const BasicBoard<Geometry>& { return *board_; }
+
+    private:
+        const BasicBoard<Geometry>* board_;
+        PieceRows piece_;
+        int y_;
+        Block block_;
+    };
+
+    using BoardView = BasicBoardView<StandardGeometry>;
+
+    // Anything that answers cell(x, y) over a whole board, a Board or a view of one
+    template <typename T>
+    concept BoardCells = requires(const T& board, size_t x, size_t y) {
+        typename T::Geometry;
+        { board.cell(x, y) } -> std::same_as<Block>;
+    };
 }
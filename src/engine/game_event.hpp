@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "engine/tetromino.hpp"
+
+
+namespace tetriz
+{
+    enum class GameEventType : uint8_t
+    {
+        Moved,      // tetromino is the piece at its new position
+        Rotated,    // tetromino is the piece after the rotation, kick is the kick table index used
+        Locked,     // tetromino is the piece as it was written to the board
+        Cleared,    // rows has bit y set for every cleared board row, numbered before the clear
+        Spawned,    // tetromino is the new piece
+        Swapped,    // tetromino.shape is the shape put into the swap slot
+        ToppedOut,  // tetromino is the piece that could not be spawned
+    };
+
+    struct GameEvent
+    {
+        Tetromino tetromino{};
+        GameEventType type{};
+        uint8_t kick = 0;
+        uint32_t rows = 0;
+    };
+
+    // Caller-owned storage the Game appends its events to, the caller drains it with clear()
+    class GameEventBuffer
+    {
+    public:
+        constexpr GameEventBuffer(std::span<GameEvent> storage)
+            : storage_(storage)
+        {}
+
+        constexpr void push(const GameEvent& event)
+        {
+            if (size_ < storage_.size())
+                storage_[size_++] = event;
+            else
+                overflowed_ = true;
+        }
+
+        constexpr void clear()
+        {
+            size_ = 0;
+            overflowed_ = false;
+        }
+
+        constexpr auto events() const -> std::span<const GameEvent> { return storage_.first(size_); }
+        constexpr auto empty() const -> bool { return size_ == 0 && !overflowed_; }
+
+        // Events were dropped since the last clear(), consumers have to resynchronise from the full state
+        constexpr auto overflowed() const -> bool { return overflowed_; }
+
+    private:
+        std::span<GameEvent> storage_;
+        size_t size_ = 0;
+        bool overflowed_ = false;
+    };
+}
@@ -32,4 +32,13 @@ namespace tetriz
     {
         return (shape == TetrominoShape::I ? kick_table_I : kick_table_other)[rotation];
     }
+
+    // Kick policy of the rules, the standard rotation system
+    struct SrsKicks
+    {
+        static constexpr auto kicks(TetrominoShape shape, TetrominoRotation rotation)
+        {
+            return kick_offsets(shape, rotation);
+        }
+    };
 }
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace tetriz
+{
+    // Player input, the same values travel over the wire as proto::Move
+    enum class Move : uint8_t
+    {
+        Left,
+        Right,
+        Down,
+        Drop,
+        Rotate,
+        Swap
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "magic_enum/magic_enum_containers.hpp"
+
+#include "engine/board_size.hpp"
+#include "engine/bounding_box.hpp"
+#include "engine/offsets.hpp"
+#include "engine/tetromino.hpp"
+
+
+namespace tetriz
+{
+    // Four consecutive board rows packed into one word, the top row in the lowest 16 bits
+    using PieceRows = uint64_t;
+
+    constexpr inline auto piece_row_bits = std::numeric_limits<RowMask>::digits;
+
+    template <typename Geometry>
+    struct PieceMasks
+    {
+        // Range of tetromino coordinates that keep every block inside the board
+        int8_t x_min = 0;
+        int8_t x_max = 0;
+        int8_t y_min = 0;
+        int8_t y_max = 0;
+
+        // Indexed by x - x_min
+        std::array<PieceRows, Geometry::width> rows{};
+
+        // Lowest block of every bounding box column, -1 for columns without blocks
+        std::array<int8_t, 4> bottom{-1, -1, -1, -1};
+
+        constexpr auto contains(int x, int y) const -> bool
+        {
+            return x >= x_min && x <= x_max && y >= y_min && y <= y_max;
+        }
+
+        constexpr auto at(int x) const -> PieceRows
+        {
+            return rows[x - x_min];
+        }
+    };
+
+    template <typename Geometry>
+    constexpr auto make_piece_masks(TetrominoShape shape, TetrominoRotation rotation) -> PieceMasks<Geometry>
+    {
+        const auto size = static_cast<int>(bounding_box_sizes[shape]);
+        const auto& side = offsets[shape][rotation];
+        const auto& bounding_box = bounding_boxes[shape][rotation];
+
+        auto masks = PieceMasks<Geometry>{
+            .x_min = static_cast<int8_t>(-side[Side::Left]),
+            .x_max = static_cast<int8_t>(Geometry::width - size + side[Side::Right]),
+            .y_min = static_cast<int8_t>(-side[Side::Top]),
+            .y_max = static_cast<int8_t>(Geometry::height - size + side[Side::Bottom]),
+        };
+
+        for (auto y = 0; y < 4; ++y)
+            for (auto column = 0; column < 4; ++column)
+                if (bounding_box[y][column])
+                    masks.bottom[column] = static_cast<int8_t>(y);
+
+        for (auto x = masks.x_min; x <= masks.x_max; ++x)
+            for (auto y = 0; y < 4; ++y)
+                for (auto column = 0; column < 4; ++column)
+                    if (bounding_box[y][column])
+                        masks.rows[x - masks.x_min] |= PieceRows{1} << (y * piece_row_bits + x + column);
+
+        return masks;
+    }
+
+    template <typename Geometry>
+    constexpr inline auto piece_masks = []{
+        auto table = magic_enum::containers::array<TetrominoShape,
+                     magic_enum::containers::array<TetrominoRotation, PieceMasks<Geometry>>>{};
+
+        for (const auto shape : magic_enum::enum_values<TetrominoShape>())
+            for (const auto rotation : magic_enum::enum_values<TetrominoRotation>())
+                table[shape][rotation] = make_piece_masks<Geometry>(shape, rotation);
+
+        return table;
+    }();
+
+    template <typename Geometry = StandardGeometry>
+    constexpr auto piece_masks_of(const Tetromino& tetromino) -> const PieceMasks<Geometry>&
+    {
+        return piece_masks<Geometry>[tetromino.shape][tetromino.rotation];
+    }
+
+    constexpr auto piece_row(PieceRows rows, size_t y) -> RowMask
+    {
+        return static_cast<RowMask>(rows >> (y * piece_row_bits));
+    }
+
+    // Dense numbering of every (x, y, rotation) a piece origin can take on the board
+    template <typename Geometry>
+    struct PieceStates
+    {
+        // Piece origins never go further than two cells past the top or the left edge
+        static constexpr auto margin = 2;
+        static constexpr auto columns = Geometry::width + margin;
+        static constexpr auto rows = Geometry::height + margin;
+        static constexpr auto count = columns * rows * magic_enum::enum_count<TetrominoRotation>();
+
+        static constexpr auto index(const Tetromino& tetromino) -> size_t
+        {
+            const auto [x, y] = tetromino.coordinates;
+            return (static_cast<size_t>(tetromino.rotation) * rows + (y + margin)) * columns + (x + margin);
+        }
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <span>
+
+#include "engine/bit_board.hpp"
+#include "engine/board_size.hpp"
+#include "engine/game.hpp"
+
+
+namespace tetriz
+{
+    // Fixed capacity list of resting positions, one entry per (x, y, rotation)
+    template <typename Geometry>
+    class BasicPlacementList
+    {
+    public:
+        constexpr void push(const Tetromino& placement) { placements_[size_++] = placement; }
+        constexpr void clear() { size_ = 0; }
+
+        constexpr auto size() const -> size_t { return size_; }
+        constexpr auto empty() const -> bool { return size_ == 0; }
+        constexpr auto operator[](size_t index) const -> const Tetromino& { return placements_[index]; }
+
+        constexpr auto begin() const { return placements_.begin(); }
+        constexpr auto end() const { return placements_.begin() + size_; }
+
+    private:
+        std::array<Tetromino, PieceStates<Geometry>::count> placements_{};
+        size_t size_ = 0;
+    };
+
+    using PlacementList = BasicPlacementList<StandardGeometry>;
+
+    // Breadth-first search over everything Game lets the piece do before it locks: shifts,
+    // soft drops and kicked rotations. A state that cannot move down is a placement.
+    template <typename Kicks = SrsKicks, typename Geometry>
+    constexpr void find_placements(const BasicBitBoard<Geometry>& board, const Tetromino& start,
+                                   BasicPlacementList<Geometry>& placements)
+    {
+        using States = PieceStates<Geometry>;
+
+        placements.clear();
+
+        if (!fits(board, start))
+            return;
+
+        auto visited = std::bitset<States::count>{};
+        auto queue = std::array<Tetromino, States::count>{};
+        auto head = 0uz;
+        auto tail = 0uz;
+
+        const auto visit = [&](const Tetromino& tetromino) {
+            const auto index = States::index(tetromino);
+            if (!visited[index])
+            {
+                visited[index] = true;
+                queue[tail++] = tetromino;
+            }
+        };
+
+        const auto try_visit = [&](Tetromino tetromino, int x, int y) {
+            tetromino.coordinates.x += x;
+            tetromino.coordinates.y += y;
+
+            if (!fits(board, tetromino))
+                return false;
+
+            visit(tetromino);
+
+            return true;
+        };
+
+        visit(start);
+        while (head != tail)
+        {
+            const auto current = queue[head++];
+
+            try_visit(current, -1, 0);
+            try_visit(current, 1, 0);
+
+            if (!try_visit(current, 0, 1))
+                placements.push(current);
+
+            if (const auto rotation = rotate<Kicks>(board, current); rotation)
+                visit(rotation->tetromino);
+        }
+    }
+
+    template <typename Rules>
+    constexpr auto find_placements(const BasicGame<Rules>& game)
+    {
+        auto placements = BasicPlacementList<typename Rules::Geometry>{};
+        find_placements<typename Rules::Kicks>(game.occupancy(), game.current(), placements);
+        return placements;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+
+namespace tetriz
+{
+    // PCG32 (XSH-RR), eight bytes of state and the same sequence on every platform
+    class Pcg32
+    {
+    public:
+        using result_type = uint32_t;
+
+        constexpr Pcg32(uint64_t seed)
+        {
+            (*this)();
+            state_ += seed;
+            (*this)();
+        }
+
+        static constexpr auto min() -> result_type { return std::numeric_limits<result_type>::min(); }
+        static constexpr auto max() -> result_type { return std::numeric_limits<result_type>::max(); }
+
+        constexpr auto operator()() -> result_type
+        {
+            const auto old = state_;
+            state_ = old * multiplier + increment;
+
+            const auto xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            const auto rotation = static_cast<uint32_t>(old >> 59);
+
+            return (xorshifted >> rotation) | (xorshifted << (-rotation & 31));
+        }
+
+    private:
+        static constexpr auto multiplier = uint64_t{6364136223846793005u};
+        static constexpr auto increment = uint64_t{1442695040888963407u};
+
+        uint64_t state_ = 0;
+    };
+
+    // Philox2x32-10 counter-based generator, the output depends only on the counter and the key
+    constexpr auto philox2x32(uint32_t counter_low, uint32_t counter_high, uint32_t key) -> std::pair<uint32_t, uint32_t>
+    {
+        constexpr auto multiplier = uint64_t{0xD256D193};
+        constexpr auto key_increment = uint32_t{0x9E3779B9};
+
+        for (auto round = 0; round < 10; ++round)
+        {
+            const auto product = multiplier * counter_low;
+            counter_low = static_cast<uint32_t>(product >> 32) ^ key ^ counter_high;
+            counter_high = static_cast<uint32_t>(product);
+            key += key_increment;
+        }
+
+        return { counter_low, counter_high };
+    }
+
+    // Unbiased integer in [0, bound), Lemire's multiply-shift with rejection
+    template <typename Generator>
+    constexpr auto uniform_below(Generator& generator, uint32_t bound) -> uint32_t
+    {
+        auto product = uint64_t{generator()} * bound;
+
+        if (static_cast<uint32_t>(product) < bound)
+        {
+            const auto threshold = -bound % bound;
+            while (static_cast<uint32_t>(product) < threshold)
+                product = uint64_t{generator()} * bound;
+        }
+
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // Fisher-Yates, unlike std::shuffle the result does not depend on the standard library
+    template <typename T, size_t N, typename Generator>
+    constexpr void shuffle(std::span<T, N> range, Generator& generator)
+    {
+        for (auto i = range.size(); i > 1; --i)
+            std::swap(range[i - 1], range[uniform_below(generator, static_cast<uint32_t>(i))]);
+    }
+}
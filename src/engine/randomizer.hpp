@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+#include "magic_enum/magic_enum.hpp"
+
+#include "engine/random.hpp"
+#include "engine/tetromino_shape.hpp"
+
+
+namespace tetriz
+{
+    using BagContents = std::span<TetrominoShape, 7>;
+
+    template <typename T>
+    concept Randomizer = std::constructible_from<T, uint32_t>
+        && requires (T randomizer, BagContents bag) { randomizer.fill(bag); };
+
+    template <typename T>
+    concept SeekableRandomizer = Randomizer<T>
+        && requires (T randomizer, uint32_t bag_index) { randomizer.seek(bag_index); };
+
+    constexpr void fill_shapes(BagContents bag)
+    {
+        std::ranges::copy(magic_enum::enum_values<TetrominoShape>(), bag.begin());
+    }
+
+    // Shuffles every bag from one running generator, bag k can only be reached through bags 0..k-1
+    class SequentialRandomizer
+    {
+    public:
+        constexpr SequentialRandomizer(uint32_t seed)
+            : generator_(seed)
+        {}
+
+        constexpr void fill(BagContents bag)
+        {
+            fill_shapes(bag);
+            tetriz::shuffle(bag, generator_);
+        }
+
+    private:
+        Pcg32 generator_;
+    };
+
+    // Bag k is a pure function of (seed, k), so any bag can be reached without replaying the ones before it
+    class CounterRandomizer
+    {
+        // Draws of a single bag, Philox of (draw, bag) keyed by the seed
+        class BagStream
+        {
+        public:
+            using result_type = uint32_t;
+
+            constexpr BagStream(uint32_t seed, uint32_t bag)
+                : seed_(seed), bag_(bag)
+            {}
+
+            static constexpr auto min() -> result_type { return 0; }
+            static constexpr auto max() -> result_type { return UINT32_MAX; }
+
+            constexpr auto operator()() -> result_type
+            {
+                return philox2x32(draw_++, bag_, seed_).first;
+            }
+
+        private:
+            uint32_t seed_;
+            uint32_t bag_;
+            uint32_t draw_ = 0;
+        };
+
+    public:
+        constexpr CounterRandomizer(uint32_t seed)
+            : seed_(seed)
+        {}
+
+        constexpr void fill(BagContents bag)
+        {
+            auto stream = BagStream(seed_, next_bag_++);
+            fill_shapes(bag);
+            tetriz::shuffle(bag, stream);
+        }
+
+        constexpr void seek(uint32_t bag_index)
+        {
+            next_bag_ = bag_index;
+        }
+
+    private:
+        uint32_t seed_;
+        uint32_t next_bag_ = 0;
+    };
+}
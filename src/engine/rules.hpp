@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include "engine/bit_board.hpp"
+#include "engine/board_size.hpp"
+#include "engine/kick_table.hpp"
+#include "engine/randomizer.hpp"
+#include "engine/tetromino.hpp"
+
+
+namespace tetriz
+{
+    struct Spawn
+    {
+        Tetromino tetromino;
+        bool topped_out;
+    };
+
+    // Spawn policy of the rules: centered in the second row, one row higher when that is
+    // blocked, tops out when both are
+    struct StandardSpawn
+    {
+        template <typename Geometry>
+        static constexpr auto coordinates = TetrominoCoordinates{ static_cast<int8_t>((Geometry::width - 4) / 2), 1 };
+
+        template <typename Geometry>
+        static constexpr auto spawn(const BasicBitBoard<Geometry>& board, TetrominoShape shape) -> Spawn
+        {
+            auto tetromino = Tetromino{
+                .shape = shape,
+                .rotation = TetrominoRotation::Base,
+                .coordinates = coordinates<Geometry>
+            };
+
+            if (fits(board, tetromino))
+                return { tetromino, false };
+
+            --tetromino.coordinates.y;
+            if (fits(board, tetromino))
+                return { tetromino, false };
+
+            ++tetromino.coordinates.y;
+            return { tetromino, true };
+        }
+    };
+
+    // Everything a game variant is compiled for, each combination gets its own constant-folded code
+    template <typename GeometryT, typename KicksT, typename RandomizerT, typename SpawnT>
+    struct GameRules
+    {
+        using Geometry = GeometryT;
+        using Kicks = KicksT;
+        using Randomizer = RandomizerT;
+        using SpawnPolicy = SpawnT;
+    };
+
+    using StandardRules = GameRules<StandardGeometry, SrsKicks, SequentialRandomizer, StandardSpawn>;
+
+    // Occupies the cells of the piece and clears the rows it completed,
+    // bit r of the result is the row tetromino.coordinates.y + r like in BitBoard::full_rows
+    template <typename Geometry>
+    constexpr auto settle(BasicBitBoard<Geometry>& board, const Tetromino& tetromino) -> uint8_t
+    {
+        const auto y = tetromino.coordinates.y;
+
+        project_on_board(board, tetromino);
+        const auto rows = board.full_rows(y);
+
+        if (rows)
+            board.clear_rows(y, rows);
+
+        return rows;
+    }
+}
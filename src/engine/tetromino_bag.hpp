@@ -2,37 +2,49 @@
 
 #include <algorithm>
 #include <generator>
-#include <random>
 
 #include "magic_enum/magic_enum.hpp"
 
+#include "engine/randomizer.hpp"
 #include "engine/tetromino_shape.hpp"
+#include "engine/zobrist.hpp"
 
 
 namespace tetriz
 {
-    class TetrominoBag
+    // Two 7-piece bags in a ring, a half is refilled as soon as the read head leaves it
+    template <Randomizer R>
+    class BasicTetrominoBag
     {
+        static constexpr auto half = 7uz;
+
     public:
-        constexpr TetrominoBag(uint32_t seed)
-            : generator_(seed)
+        constexpr BasicTetrominoBag(uint32_t seed)
+            : randomizer_(seed)
         {
-            fill(left_half());
-            fill(right_half());
+            hash_ ^= Keys::state(randomizer_);
+            fill(0);
+            fill(half);
         }
 
         constexpr auto poll() -> TetrominoShape
         {
-            const auto next = bag_.front();
-            std::shift_left(bag_.begin(), bag_.end(), 1);
+            const auto next = bag_[head_];
+            advance(1);
+
+            return next;
+        }
 
-            if (++current_shift_ == 7)
+        // Same as polling pieces.size() times in a row, copies whole runs between refills
+        constexpr void poll(std::span<TetrominoShape> pieces)
+        {
+            while (!pieces.empty())
             {
-                fill(right_half());
-                current_shift_ = 0;
+                const auto count = std::min(pieces.size(), half - head_ % half);
+                std::ranges::copy_n(bag_.begin() + head_, count, pieces.begin());
+                pieces = pieces.subspan(count);
+                advance(count);
             }
-
-            return next;
         }
 
         template <size_t N>
@@ -40,29 +52,95 @@ namespace tetriz
         constexpr auto peek() const
         {
             auto result = std::array<TetrominoShape, N>{};
-            std::ranges::copy_n(bag_.begin(), N, result.begin());
+            for (auto i = 0uz; i < N; ++i)
+                result[i] = bag_[(head_ + i) % bag_.size()];
+
             return result;
         }
 
+        // Positions the bag as if piece_index pieces had been polled since construction
+        constexpr void seek(uint64_t piece_index)
+        requires SeekableRandomizer<R>
+        {
+            const auto bag_index = static_cast<uint32_t>(piece_index / half);
+            const auto current = bag_index % 2 * half;
+
+            hash_ ^= Keys::state(randomizer_);
+            randomizer_.seek(bag_index);
+            hash_ ^= Keys::state(randomizer_);
+            fill(current);
+            fill(half - current);
+            move_head(current + piece_index % half);
+        }
+
+        // Zobrist key of the read head, both halves and the randomizer, kept up to date on every poll
+        constexpr auto hash() const -> uint64_t { return hash_; }
+
+        // Whether the bag could have come from the engine, for bags read from outside of it:
+        // the head inside the ring, a shape in every slot and a hash that matches them
+        constexpr auto valid() const -> bool
+        {
+            return head_ < bag_.size()
+                && std::ranges::all_of(bag_, [](TetrominoShape shape) { return magic_enum::enum_contains(shape); })
+                && hash_ == (Keys::heads[head_] ^ Keys::state(randomizer_) ^ half_key(0) ^ half_key(half));
+        }
+
     private:
-        constexpr void fill(std::span<TetrominoShape, 7> range)
+        using Keys = zobrist::BagKeys<2 * half>;
+
+        constexpr void fill(size_t begin)
         {
-            std::ranges::copy(magic_enum::enum_values<TetrominoShape>(), range.begin());
-            std::ranges::shuffle(range, generator_);
+            hash_ ^= half_key(begin) ^ Keys::state(randomizer_);
+            randomizer_.fill(std::span(bag_).subspan(begin).template first<half>());
+            hash_ ^= half_key(begin) ^ Keys::state(randomizer_);
+        }
+
+        constexpr void advance(size_t count)
+        {
+            const auto head = head_ + count;
+
+            if (head == bag_.size())
+            {
+                move_head(0);
+                fill(half);
+            }
+            else
+            {
+                move_head(head);
+                if (head == half)
+                    fill(0);
+            }
         }
 
-        constexpr auto left_half() -> std::span<TetrominoShape, 7>
+        constexpr void move_head(size_t head)
         {
-            return std::span(bag_).first<7>();
+            hash_ ^= Keys::heads[head_] ^ Keys::heads[head];
+            head_ = static_cast<uint8_t>(head);
         }
 
-        constexpr auto right_half() -> std::span<TetrominoShape, 7>
+        constexpr auto half_key(size_t begin) const -> uint64_t
         {
-            return std::span(bag_).last<7>();
+            auto key = uint64_t{0};
+            for (auto slot = begin; slot < begin + half; ++slot)
+                key ^= Keys::slot(slot, bag_[slot]);
+
+            return key;
         }
 
-        uint8_t current_shift_;
-        std::mt19937 generator_;
-        std::array<TetrominoShape, 14> bag_;
+        static constexpr auto empty_hash = []{
+            auto key = Keys::heads[0];
+            for (auto slot = 0uz; slot < 2 * half; ++slot)
+                key ^= Keys::slot(slot, TetrominoShape{});
+
+            return key;
+        }();
+
+        uint8_t head_ = 0;
+        R randomizer_;
+        std::array<TetrominoShape, 2 * half> bag_{};
+        uint64_t hash_ = empty_hash;
     };
+
+    using TetrominoBag = BasicTetrominoBag<SequentialRandomizer>;
+    using SeekableTetrominoBag = BasicTetrominoBag<CounterRandomizer>;
 }
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+
+#include "magic_enum/magic_enum.hpp"
+
+#include "engine/board_size.hpp"
+#include "engine/piece_masks.hpp"
+#include "engine/tetromino.hpp"
+
+
+namespace tetriz::zobrist
+{
+    namespace detail
+    {
+        constexpr auto splitmix64(uint64_t& state) -> uint64_t
+        {
+            auto z = (state += 0x9E37'79B9'7F4A'7C15u);
+            z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9u;
+            z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EBu;
+            return z ^ (z >> 31);
+        }
+
+        template <size_t N>
+        constexpr auto make_keys(uint64_t seed) -> std::array<uint64_t, N>
+        {
+            auto keys = std::array<uint64_t, N>{};
+            for (auto& key : keys)
+                key = splitmix64(seed);
+
+            return keys;
+        }
+
+        // Shapes are numbered from 1, the value 0 stands for no shape (an empty slot) and has keys of its own
+        constexpr inline auto shape_values = magic_enum::enum_count<TetrominoShape>() + 1;
+
+        constexpr auto shape_value(TetrominoShape shape) -> size_t
+        {
+            return static_cast<size_t>(shape);
+        }
+
+        constexpr auto shape_value(std::optional<TetrominoShape> shape) -> size_t
+        {
+            return shape ? shape_value(*shape) : 0;
+        }
+    }
+
+    // Every table has its own seed so that no two tables share keys
+    template <typename Geometry>
+    constexpr inline auto cells = detail::make_keys<Geometry::height * Geometry::width>(1);
+
+    template <typename Geometry>
+    constexpr inline auto pieces = detail::make_keys<detail::shape_values * PieceStates<Geometry>::count>(2);
+
+    constexpr inline auto swapped_keys = detail::make_keys<detail::shape_values>(3);
+    constexpr inline auto just_swapped = detail::make_keys<1>(4)[0];
+    constexpr inline auto finished = detail::make_keys<1>(5)[0];
+
+    template <typename Geometry = StandardGeometry>
+    constexpr auto cell(size_t x, size_t y) -> uint64_t
+    {
+        return cells<Geometry>[y * Geometry::width + x];
+    }
+
+    template <typename Geometry = StandardGeometry>
+    constexpr auto row(size_t y, RowMask mask) -> uint64_t
+    {
+        auto key = uint64_t{0};
+        for (auto bits = mask; bits; bits &= bits - 1)
+            key ^= cell<Geometry>(std::countr_zero(bits), y);
+
+        return key;
+    }
+
+    template <typename Geometry = StandardGeometry>
+    constexpr auto piece(const Tetromino& tetromino) -> uint64_t
+    {
+        return pieces<Geometry>[detail::shape_value(tetromino.shape) * PieceStates<Geometry>::count
+                              + PieceStates<Geometry>::index(tetromino)];
+    }
+
+    // Key of the swap slot, an empty slot included
+    constexpr auto swapped(std::optional<TetrominoShape> shape) -> uint64_t
+    {
+        return swapped_keys[detail::shape_value(shape)];
+    }
+
+    // Keys for a bag of the given number of slots, one per slot and shape plus one per read head position,
+    // the randomizer state is mixed in from its bytes
+    template <size_t Slots>
+    struct BagKeys
+    {
+        static constexpr auto slots = detail::make_keys<Slots * detail::shape_values>(6);
+        static constexpr auto heads = detail::make_keys<Slots>(7);
+        static constexpr auto randomizer = detail::make_keys<1>(8)[0];
+
+        static constexpr auto slot(size_t index, TetrominoShape shape) -> uint64_t
+        {
+            return slots[index * detail::shape_values + detail::shape_value(shape)];
+        }
+
+        template <typename R>
+        static constexpr auto state(const R& randomizer) -> uint64_t
+        {
+            auto key = BagKeys::randomizer;
+            for (const auto byte : std::bit_cast<std::array<uint8_t, sizeof(R)>>(randomizer))
+            {
+                auto state = key ^ byte;
+                key = detail::splitmix64(state);
+            }
+
+            return key;
+        }
+    };
+}
@@ -4,8 +4,12 @@
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
 
+#include <fstream>
+#include <mutex>
+
 #include "engine/game.hpp"
 #include "game/renderer.hpp"
+#include "proto/replay.hpp"
 
 using namespace ftxui;
 using namespace std::chrono_literals;
@@ -14,26 +18,41 @@ using namespace std::chrono_literals;
 auto main(int argc, char** argv) -> int
 {
     const auto time = [start_time = Clock::now()]{
-        return std::chrono::duration_cast<Duration>(
-            std::chrono::high_resolution_clock::now() - start_time);
+        return std::chrono::duration_cast<Duration>(Clock::now() - start_time);
     };
 
-    auto game = tetriz::Game(4);
-    auto game_renderer = make_board_renderer(game, time);
+    constexpr auto seed = 4u;
+    auto game = tetriz::Game(seed);
+
+    // Keys and gravity come from different threads, every input is applied and recorded under the lock
+    // and the screen reads the game under it too
+    auto game_mutex = std::mutex{};
+    const auto board_renderer = make_board_renderer(game, time);
+    auto game_renderer = Renderer(board_renderer, [&] {
+        const auto lock = std::scoped_lock(game_mutex);
+        return board_renderer->Render();
+    });
+
+    auto inputs = std::vector<tetriz::proto::ReplayInput>{};
+    const auto play = [&](tetriz::Move move) {
+        const auto lock = std::scoped_lock(game_mutex);
+        game.apply(move);
+        inputs.push_back({ time(), move });
+    };
 
     auto event_listener = CatchEvent(game_renderer, [&](const Event& e) {
         if (e == Event::ArrowLeft || e == Event::Character('h'))
-            game.move(tetriz::Direction::Left);
+            play(tetriz::Move::Left);
         else if (e == Event::ArrowRight || e == Event::Character('l'))
-            game.move(tetriz::Direction::Right);
+            play(tetriz::Move::Right);
         else if (e == Event::ArrowDown || e == Event::Character('j'))
-            game.move(tetriz::Direction::Down);
+            play(tetriz::Move::Down);
         else if (e == Event::ArrowUp || e == Event::Character('k'))
-            game.rotate();
+            play(tetriz::Move::Rotate);
         else if (e == Event::Character('c'))
-            game.swap();
+            play(tetriz::Move::Swap);
         else if (e == Event::Character(' '))
-            game.drop();
+            play(tetriz::Move::Drop);
         else
             return false;
 
@@ -50,7 +69,7 @@ auto main(int argc, char** argv) -> int
         {
             if (std::chrono::steady_clock::now() >= next_tick)
             {
-                game.move(tetriz::Direction::Down);
+                play(tetriz::Move::Down);
                 next_tick += 1s;
             }
 
@@ -61,6 +80,17 @@ auto main(int argc, char** argv) -> int
 
     screen.Loop(event_listener);
     running = false;
+    game_worker.join();
+
+    // The first argument names a file to keep the game in, tetriz_replay plays it back
+    if (argc > 1)
+    {
+        auto replay = tetriz::proto::Replay{ .seed = seed, .players = { { game.hash(), inputs } } };
+        tetriz::proto::add_keyframes(replay);
+
+        auto output = std::ofstream(argv[1], std::ios::binary);
+        tetriz::proto::write_replay(output, replay);
+    }
 
     return 0;
 }
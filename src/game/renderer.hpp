@@ -29,14 +29,12 @@ constexpr auto block_to_color(tetriz::Block block) -> Color
     }
 }
 
-constexpr auto render(const tetriz::Board& board, const tetriz::Tetromino& tetromino)
+constexpr auto render(const tetriz::BoardCells auto& board)
 {
-    return canvas(10*4, 20*4, [&](Canvas& canvas) {
-        const auto board_raw = project_on_board(board, tetromino);
-
+    return canvas(10*4, 20*4, [board](Canvas& canvas) {
         for (int r = 0; r < 20; r++)
             for (int c = 0; c < 10; c++)
-                canvas.DrawText(c * 4, r * 4, " ┘", [b=board_raw[r+2][c]](Pixel &p) {
+                canvas.DrawText(c * 4, r * 4, " ┘", [b=board[r+2][c]](Pixel &p) {
                     p.foreground_color = Color::GrayDark;
                     if (b != tetriz::Block::Void)
                         p.background_color = block_to_color(b);
@@ -116,7 +114,7 @@ inline
 auto make_board_renderer(const tetriz::Game& game, const auto& time_source) -> Component
 {
     return Renderer([&] {
-        const auto board = render(game.board(), game.current());
+        const auto board = render(game.view());
         const auto bag = render(game.bag().peek<4>());
         const auto swap = render(game.swapped());
         const auto score = render(game.score());
@@ -129,7 +127,7 @@ auto make_board_renderer(const tetriz::Game& game, const auto& time_source) -> C
 inline
 auto render(const tetriz::proto::DatagramGame& game, const tetriz::proto::DatagramTime& time) -> Elements
 {
-    const auto board = render(game.board, game.current);
+    const auto board = render(tetriz::BoardView(game.board, game.current));
     const auto bag = render(game.bag);
     const auto swap = render(game.swap);
     const auto score = render(game.score);
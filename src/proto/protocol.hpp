@@ -6,6 +6,7 @@
 
 #include "engine/game.hpp"
 #include "engine/game_board.hpp"
+#include "engine/move.hpp"
 
 #include "proto/serializers.hpp"
 #include "util/time.hpp"
@@ -21,15 +22,7 @@ namespace tetriz::proto
         Hola,
     };
 
-    enum class Move : uint8_t
-    {
-        Left,
-        Right,
-        Down,
-        Drop,
-        Rotate,
-        Swap
-    };
+    using Move = tetriz::Move;
 
     struct DatagramMove
     {
@@ -41,6 +34,7 @@ namespace tetriz::proto
     struct DatagramGame
     {
         uint8_t player_id{};
+        // Sent as its rows top to bottom, the storage order of the board stays local
         Board board{};
         Tetromino current{};
         std::optional<TetrominoShape> swap = {};
@@ -86,7 +80,7 @@ namespace tetriz::proto
                     .type = MessageType::Game,
                     .payload = DatagramGame{
                         .player_id = pop_from<uint8_t>(message),
-                        .board = pop_from<Board>(message),
+                        .board = Board(pop_from<BoardRows>(message)),
                         .current = pop_from<Tetromino>(message),
                         .swap = pop_from<std::optional<TetrominoShape>>(message),
                         .bag = pop_from<Bag>(message),
@@ -112,6 +106,23 @@ namespace tetriz::proto
         }
     }
 
+    constexpr inline auto move_datagram_size = pack_size<MessageType, DatagramMove>;
+
+    // Reads the run of Move datagrams at the front of the message, returns how many were stored.
+    // The run can be longer than moves, the rest starts count * move_datagram_size bytes in.
+    constexpr auto deserialize_moves(std::span<const uint8_t> message, std::span<Move> moves) -> size_t
+    {
+        auto count = 0uz;
+        while (count < moves.size()
+            && message.size() >= move_datagram_size
+            && pop_from<MessageType>(message) == MessageType::Move)
+        {
+            moves[count++] = pop_from<DatagramMove>(message).move;
+        }
+
+        return count;
+    }
+
     constexpr auto serialize_move(Move move)
     {
         return serialize(MessageType::Move, move);
@@ -122,7 +133,7 @@ namespace tetriz::proto
         return serialize(
             MessageType::Game,
             player_id,
-            game.board(),
+            game.board().rows(),
             game.current(),
             game.swapped(),
             game.bag().peek<sizeof(DatagramGame::bag)>(),
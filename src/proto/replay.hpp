@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "engine/game.hpp"
+#include "engine/move.hpp"
+#include "magic_enum/magic_enum.hpp"
+#include "util/time.hpp"
+
+
+namespace tetriz::proto
+{
+    // Bumped whenever the same seed and inputs could play out differently, replays
+    // recorded by another engine version are refused instead of silently diverging
+    constexpr inline auto engine_version = uint32_t{1};
+
+    constexpr inline auto replay_magic = std::array<char, 4>{ 'T', 'Z', 'R', 'P' };
+    constexpr inline auto replay_format = uint16_t{1};
+
+    constexpr inline auto default_keyframe_interval = 50uz;
+
+    // One input as the server applied it, gravity ticks are recorded as Down since that is what they do
+    struct ReplayInput
+    {
+        Duration timestamp{};
+        Move move{};
+        std::array<uint8_t, 3> reserved{};
+    };
+
+    static_assert(sizeof(ReplayInput) == 8);
+
+    // The game after the first input_index inputs, the last of which came at timestamp
+    struct ReplayKeyframe
+    {
+        uint32_t input_index = 0;
+        Duration timestamp{};
+        GameSnapshot snapshot;
+    };
+
+    struct ReplayPlayer
+    {
+        // Game::hash() at the end of the recording, what a re-simulation has to arrive at
+        uint64_t final_hash = 0;
+        std::vector<ReplayInput> inputs;
+        // In input order, seeking restores the last one before the target and plays on from there
+        std::vector<ReplayKeyframe> keyframes = {};
+    };
+
+    // Every player of a room starts from the same seed, the room size is players.size()
+    struct Replay
+    {
+        uint32_t engine = engine_version;
+        uint32_t seed = 0;
+        std::vector<ReplayPlayer> players;
+    };
+
+    // On disk the header is followed by a ReplayPlayerHeader per player, the inputs of every player
+    // in turn, the keyframe index of every player in turn and last the keyframe snapshots in the
+    // same order. Records are fixed size, so a reader that only wants one keyframe can find it
+    // from the counts. Fields are stored as the host lays them out, like the datagrams, and the
+    // snapshots are only meaningful to the engine version that wrote them. Nothing read is trusted,
+    // a file that fails any check is refused as a whole.
+    struct ReplayHeader
+    {
+        std::array<char, 4> magic = replay_magic;
+        uint16_t format = replay_format;
+        uint16_t room_size = 0;
+        uint32_t engine = 0;
+        uint32_t seed = 0;
+    };
+
+    struct ReplayPlayerHeader
+    {
+        uint64_t final_hash = 0;
+        uint32_t input_count = 0;
+        uint32_t keyframe_count = 0;
+    };
+
+    struct ReplayKeyframeEntry
+    {
+        uint32_t input_index = 0;
+        Duration timestamp{};
+    };
+
+    // A keyframe's GameSnapshot in fields that any bytes are a valid value of, so a file can be
+    // read into one and checked before anything is built from it. The occupancy mirror is not
+    // stored, it is rebuilt from the board.
+    struct ReplaySnapshot
+    {
+        BoardRows board{};
+        TetrominoBag bag;
+        Tetromino current{};
+        // Shape in the swap slot, 0 when it is empty
+        uint8_t swapped = 0;
+        uint8_t just_swapped = 0;
+        uint8_t finished = 0;
+        uint16_t score = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ReplaySnapshot>);
+
+    namespace detail
+    {
+        template <typename T, size_t N>
+        void write_raw(std::ostream& output, std::span<const T, N> values)
+        {
+            output.write(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+        }
+
+        template <typename T, size_t N>
+        auto read_raw(std::istream& input, std::span<T, N> values) -> bool
+        {
+            input.read(reinterpret_cast<char*>(values.data()), values.size_bytes());
+            return input.gcount() == static_cast<std::streamsize>(values.size_bytes());
+        }
+
+        // Reads count values in chunks, a count made up by the file fails once the input runs out
+        // rather than being allocated up front
+        template <typename T>
+        auto read_counted(std::istream& input, std::vector<T>& values, size_t count) -> bool
+        {
+            constexpr auto chunk = std::max(1uz, (64uz << 10) / sizeof(T));
+
+            values.clear();
+            while (values.size() < count)
+            {
+                const auto read = values.size();
+                values.resize(std::min(count, read + chunk));
+                if (!read_raw(input, std::span(values).subspan(read)))
+                    return false;
+            }
+
+            return true;
+        }
+
+        inline auto stored(const GameSnapshot& snapshot) -> ReplaySnapshot
+        {
+            return {
+                .board = snapshot.board.rows(),
+                .bag = snapshot.bag,
+                .current = snapshot.current,
+                .swapped = snapshot.swapped ? static_cast<uint8_t>(*snapshot.swapped) : uint8_t{0},
+                .just_swapped = snapshot.just_swapped,
+                .finished = snapshot.finished,
+                .score = snapshot.score,
+            };
+        }
+
+        // Every field in the range the engine produces, anything else could index past its tables.
+        // The piece has to lie inside the board, and clear of the stack unless the game is over.
+        inline auto valid(const ReplaySnapshot& snapshot) -> bool
+        {
+            const auto [x, y] = snapshot.current.coordinates;
+
+            return std::ranges::all_of(snapshot.board, [](const BoardRow& row) {
+                    return std::ranges::all_of(row, [](Block block) { return magic_enum::enum_contains(block); });
+                })
+                && snapshot.bag.valid()
+                && magic_enum::enum_contains(snapshot.current.shape)
+                && magic_enum::enum_contains(snapshot.current.rotation)
+                && piece_masks_of(snapshot.current).contains(x, y)
+                && (snapshot.swapped == 0 || magic_enum::enum_contains(static_cast<TetrominoShape>(snapshot.swapped)))
+                && snapshot.just_swapped <= 1
+                && snapshot.finished <= 1
+                && (snapshot.finished != 0 || fits(BitBoard(Board(snapshot.board)), snapshot.current));
+        }
+
+        inline auto restored(const ReplaySnapshot& snapshot) -> GameSnapshot
+        {
+            const auto board = Board(snapshot.board);
+
+            return {
+                .board = board,
+                .occupancy = BitBoard(board),
+                .bag = snapshot.bag,
+                .current = snapshot.current,
+                .swapped = snapshot.swapped != 0 ? std::optional(static_cast<TetrominoShape>(snapshot.swapped)) : std::nullopt,
+                .score = snapshot.score,
+                .just_swapped = snapshot.just_swapped != 0,
+                .finished = snapshot.finished != 0,
+            };
+        }
+    }
+
+    inline void write_replay(std::ostream& output, const Replay& replay)
+    {
+        const auto header = ReplayHeader{
+            .room_size = static_cast<uint16_t>(replay.players.size()),
+            .engine = replay.engine,
+            .seed = replay.seed,
+        };
+        detail::write_raw(output, std::span(&header, 1));
+
+        for (const auto& player : replay.players)
+        {
+            const auto player_header = ReplayPlayerHeader{
+                .final_hash = player.final_hash,
+                .input_count = static_cast<uint32_t>(player.inputs.size()),
+                .keyframe_count = static_cast<uint32_t>(player.keyframes.size()),
+            };
+            detail::write_raw(output, std::span(&player_header, 1));
+        }
+
+        for (const auto& player : replay.players)
+            detail::write_raw(output, std::span(player.inputs));
+
+        for (const auto& player : replay.players)
+            for (const auto& keyframe : player.keyframes)
+            {
+                const auto entry = ReplayKeyframeEntry{ keyframe.input_index, keyframe.timestamp };
+                detail::write_raw(output, std::span(&entry, 1));
+            }
+
+        for (const auto& player : replay.players)
+            for (const auto& keyframe : player.keyframes)
+            {
+                const auto snapshot = detail::stored(keyframe.snapshot);
+                detail::write_raw(output, std::span(&snapshot, 1));
+            }
+    }
+
+    // Nothing for files that are truncated or not replays of this format, counts in the file are
+    // checked against its size as they are read
+    inline auto read_replay(std::istream& input) -> std::optional<Replay>
+    {
+        auto header = ReplayHeader{};
+        if (!detail::read_raw(input, std::span(&header, 1)) || header.magic != replay_magic || header.format != replay_format)
+            return std::nullopt;
+
+        auto player_headers = std::vector<ReplayPlayerHeader>{};
+        if (!detail::read_counted(input, player_headers, header.room_size))
+            return std::nullopt;
+
+        auto replay = Replay{ .engine = header.engine, .seed = header.seed };
+        for (const auto& player_header : player_headers)
+        {
+            auto& player = replay.players.emplace_back(player_header.final_hash);
+            if (!detail::read_counted(input, player.inputs, player_header.input_count))
+                return std::nullopt;
+
+            // seek() relies on the inputs being in time order
+            if (!std::ranges::all_of(player.inputs, [](const ReplayInput& input) { return magic_enum::enum_contains(input.move); })
+                || !std::ranges::is_sorted(player.inputs, {}, &ReplayInput::timestamp))
+                return std::nullopt;
+        }
+
+        auto entries = std::vector<std::vector<ReplayKeyframeEntry>>{};
+        for (auto player = 0uz; player < player_headers.size(); ++player)
+        {
+            auto& player_entries = entries.emplace_back();
+            if (!detail::read_counted(input, player_entries, player_headers[player].keyframe_count))
+                return std::nullopt;
+
+            // Each keyframe follows an input, in input order, and carries that input's timestamp,
+            // which keeps them sorted by time for seek()
+            const auto& inputs = replay.players[player].inputs;
+            auto previous = 0uz;
+            for (const auto& entry : player_entries)
+            {
+                if (entry.input_index <= previous || entry.input_index > inputs.size()
+                    || entry.timestamp != inputs[entry.input_index - 1].timestamp)
+                    return std::nullopt;
+
+                previous = entry.input_index;
+            }
+        }
+
+        // Snapshots have no empty state to read into, they are copied out of their bytes
+        auto bytes = std::array<char, sizeof(ReplaySnapshot)>{};
+        for (auto player = 0uz; player < replay.players.size(); ++player)
+            for (const auto& entry : entries[player])
+            {
+                if (!detail::read_raw(input, std::span(bytes)))
+                    return std::nullopt;
+
+                const auto snapshot = std::bit_cast<ReplaySnapshot>(bytes);
+                if (!detail::valid(snapshot))
+                    return std::nullopt;
+
+                replay.players[player].keyframes.push_back({
+                    entry.input_index, entry.timestamp, detail::restored(snapshot)
+                });
+            }
+
+        return replay;
+    }
+
+    // Replaces the keyframes of every player with one snapshot every pieces_per_keyframe locked pieces
+    inline void add_keyframes(Replay& replay, size_t pieces_per_keyframe = default_keyframe_interval)
+    {
+        for (auto& player : replay.players)
+        {
+            player.keyframes.clear();
+
+            auto game = Game(replay.seed);
+            auto storage = std::array<GameEvent, 16>{};
+            auto events = GameEventBuffer(storage);
+            game.set_event_buffer(&events);
+
+            auto pieces = 0uz;
+            for (const auto [index, input] : player.inputs | std::views::enumerate)
+            {
+                game.apply(input.move);
+                pieces += std::ranges::count(events.events(), GameEventType::Locked, &GameEvent::type);
+                events.clear();
+
+                if (pieces >= std::max(pieces_per_keyframe, 1uz))
+                {
+                    player.keyframes.push_back({ static_cast<uint32_t>(index + 1), input.timestamp, game.snapshot() });
+                    pieces = 0;
+                }
+            }
+        }
+    }
+
+    // The game of the player once every input up to and including the timestamp was applied,
+    // starts from the nearest keyframe so at most a keyframe interval of inputs is simulated
+    inline auto seek(const Replay& replay, size_t player, Duration timestamp) -> Game
+    {
+        const auto& recording = replay.players[player];
+        const auto after = std::ranges::upper_bound(recording.keyframes, timestamp, {}, &ReplayKeyframe::timestamp);
+
+        auto game = after == recording.keyframes.begin() ? Game(replay.seed) : Game(std::prev(after)->snapshot);
+        auto index = after == recording.keyframes.begin() ? 0uz : std::prev(after)->input_index;
+
+        for (; index < recording.inputs.size() && recording.inputs[index].timestamp <= timestamp; ++index)
+            game.apply(recording.inputs[index].move);
+
+        return game;
+    }
+
+    // Plays the recorded inputs of one player again, as fast as they can be applied
+    inline auto simulate(const Replay& replay, size_t player) -> Game
+    {
+        auto game = Game(replay.seed);
+        for (const auto& input : replay.players[player].inputs)
+            game.apply(input.move);
+
+        return game;
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "engine/game.hpp"
 #include "proto/protocol.hpp"
+#include "proto/replay.hpp"
 
 
 using namespace std::chrono_literals;
@@ -12,31 +13,34 @@ class GameEngine
 public:
     GameEngine(uint32_t seed)
         : game_(seed)
-    {}
-
-    void action(tetriz::proto::Move move)
     {
-        using tetriz::proto::Move;
-        using tetriz::Direction;
+        game_.set_event_buffer(&events_);
+    }
 
+    GameEngine(const GameEngine&) = delete;
+    auto operator=(const GameEngine&) -> GameEngine& = delete;
+
+    void action(tetriz::proto::Move move, Duration timestamp)
+    {
         log_trace("Move: {}", magic_enum::enum_name(move));
+        game_.apply(move);
+        inputs_.push_back({ timestamp, move });
+    }
+
+    void actions(std::span<const tetriz::proto::Move> moves, Duration timestamp)
+    {
+        log_trace("Moves: {}", moves.size());
+        game_.apply(moves);
 
-        [this, move] {
-            switch (move)
-            {
-                case Move::Left:   return game_.move(Direction::Left);
-                case Move::Right:  return game_.move(Direction::Right);
-                case Move::Down:   return game_.move(Direction::Down);
-                case Move::Drop:   return game_.drop();
-                case Move::Rotate: return game_.rotate();
-                case Move::Swap:   return game_.swap();
-            }
-        }();
+        for (const auto move : moves)
+            inputs_.push_back({ timestamp, move });
     }
 
-    void tick()
+    // Gravity, recorded as the Down it amounts to
+    void tick(Duration timestamp)
     {
         game_.tick();
+        inputs_.push_back({ timestamp, tetriz::proto::Move::Down });
     }
 
     auto game() const -> const tetriz::Game&
@@ -44,6 +48,28 @@ public:
         return game_;
     }
 
+    // Whether the game changed since the last flush, nothing was broadcast before the first one
+    auto changed() const -> bool
+    {
+        return !flushed_ || !events_.empty();
+    }
+
+    void flush()
+    {
+        events_.clear();
+        flushed_ = true;
+    }
+
+    // Everything applied so far, together with the seed it is enough to play the game again
+    auto recording() const -> tetriz::proto::ReplayPlayer
+    {
+        return { game_.hash(), inputs_ };
+    }
+
 private:
     tetriz::Game game_;
+    std::array<tetriz::GameEvent, 64> event_storage_{};
+    tetriz::GameEventBuffer events_{event_storage_};
+    bool flushed_ = false;
+    std::vector<tetriz::proto::ReplayInput> inputs_;
 };
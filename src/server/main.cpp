@@ -1,4 +1,5 @@
 #include <csignal>
+#include <cstdlib>
 
 #include "logger.hpp"
 #include "epoll.hpp"
@@ -19,9 +20,8 @@ RoomList rooms;
 
 void notify(net::ConnectionWrapper client)
 {
-    const auto message = client
-        .read()
-        .and_then(tetriz::proto::deserialize);
+    const auto received = client.read();
+    const auto message = received.and_then(tetriz::proto::deserialize);
 
     if (!message)
     {
@@ -31,6 +31,24 @@ void notify(net::ConnectionWrapper client)
         return;
     }
 
+    if (message->type == tetriz::proto::MessageType::Move)
+    {
+        const auto room = rooms.get_room(client);
+        if (!room)
+            return;
+
+        // Bursts longer than the buffer are applied a buffer at a time until the run of moves ends
+        auto moves = std::array<tetriz::proto::Move, 64>{};
+        auto rest = std::span<const uint8_t>(*received);
+        while (const auto count = tetriz::proto::deserialize_moves(rest, moves))
+        {
+            room->get().notify(client, std::span(moves).first(count));
+            rest = rest.subspan(count * tetriz::proto::move_datagram_size);
+        }
+
+        return;
+    }
+
     if (message->type == tetriz::proto::MessageType::Hola)
     {
         rooms.get_available_room(std::get<tetriz::proto::DatagramHola>(message->payload).room_size)
@@ -53,6 +71,9 @@ auto main(int argc, char** argv) -> int
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
 
+    if (const auto* directory = std::getenv("TETRIZ_REPLAY_DIR"))
+        Room::replay_directory = directory;
+
     auto epoll = make_epoll();
     auto socket = net::ServerSocket();
     socket.set_non_blocking();
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "logger.hpp"
+#include "proto/replay.hpp"
+
+
+// Keyframes and writes replays on a thread of its own, in the order they were queued, so the
+// rooms that hand them over never wait on the replay or the disk. Replays still queued when the
+// saver is destroyed are written before it returns.
+class ReplaySaver
+{
+public:
+    ReplaySaver() = default;
+
+    ReplaySaver(const ReplaySaver&) = delete;
+    auto operator=(const ReplaySaver&) -> ReplaySaver& = delete;
+
+    void save(uint32_t room_id, tetriz::proto::Replay replay, std::filesystem::path path)
+    {
+        {
+            const auto lock = std::scoped_lock(mutex_);
+            jobs_.push_back({ room_id, std::move(replay), std::move(path) });
+        }
+
+        wake_.notify_one();
+    }
+
+private:
+    struct Job
+    {
+        uint32_t room_id;
+        tetriz::proto::Replay replay;
+        std::filesystem::path path;
+    };
+
+    void run(std::stop_token stop)
+    {
+        while (true)
+        {
+            auto lock = std::unique_lock(mutex_);
+            wake_.wait(lock, stop, [this] { return !jobs_.empty(); });
+
+            // Only a stop wakes it with nothing queued
+            if (jobs_.empty())
+                return;
+
+            auto job = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+
+            write(job);
+        }
+    }
+
+    static void write(Job& job)
+    {
+        tetriz::proto::add_keyframes(job.replay);
+
+        auto output = std::ofstream(job.path, std::ios::binary);
+        tetriz::proto::write_replay(output, job.replay);
+
+        if (output)
+            log_info("room #{}: replay saved to {}", job.room_id, job.path.string());
+        else
+            log_error("room #{}: could not write replay to {}", job.room_id, job.path.string());
+    }
+
+    std::mutex mutex_;
+    std::condition_variable_any wake_;
+    std::deque<Job> jobs_;
+    // Last, so it is stopped and joined while the queue is still there
+    std::jthread worker_ = std::jthread([this](std::stop_token stop) { run(stop); });
+};
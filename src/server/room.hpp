@@ -1,23 +1,32 @@
 #pragma once
 
+#include <filesystem>
 #include <map>
+#include <mutex>
 #include <thread>
 
 #include "networking_socket.hpp"
 #include "server/game_engine.hpp"
+#include "server/replay_saver.hpp"
 #include "util/time.hpp"
 #include "proto/protocol.hpp"
+#include "proto/replay.hpp"
 
 
 class Room
 {
 public:
+    // Where rooms save their replay once the last player left, nothing is saved without it
+    inline static auto replay_directory = std::optional<std::filesystem::path>{};
+
     Room(uint32_t room_size)
         : room_size_(room_size)
     {}
 
     void notify(net::ConnectionWrapper client, const tetriz::proto::Datagram& message)
     {
+        const auto lock = std::scoped_lock(mutex_);
+
         if (!games_.contains(client))
         {
             if (message.type == tetriz::proto::MessageType::Hola)
@@ -36,28 +45,34 @@ public:
 
         if (message.type == tetriz::proto::MessageType::Move)
         {
-            if (start_time_ > Clock::now())
-            {
-                log_trace("Won't notify, game has not started yet");
-                return;
-            }
-
-            games_
-                .at(client.descriptor())
-                .action(std::get<tetriz::proto::DatagramMove>(message.payload).move);
-
-            //notify_move(client);
-            notify_tick();
+            const auto move = std::get<tetriz::proto::DatagramMove>(message.payload).move;
+            play(client, std::span(&move, 1));
             return;
         }
 
         log_info("Received unexpected message type!");
     }
 
+    // Applies a burst of moves that arrived together and broadcasts the result once
+    void notify(net::ConnectionWrapper client, std::span<const tetriz::proto::Move> moves)
+    {
+        const auto lock = std::scoped_lock(mutex_);
+        play(client, moves);
+    }
+
     void leave(net::ConnectionWrapper client)
     {
-        games_.erase(client);
+        const auto lock = std::scoped_lock(mutex_);
+
+        if (const auto game = games_.find(client); game != games_.end() && start_time_ < Clock::now())
+            departed_.push_back(game->second.recording());
+
+        if (games_.erase(client))
+            roster_changed_ = true;
         client.close();
+
+        if (games_.empty() && !departed_.empty())
+            save_replay();
     }
 
     void stop()
@@ -92,6 +107,12 @@ private:
     uint32_t room_size_ = 0;
     uint32_t room_seed_ = Clock::now().time_since_epoch().count();
     std::map<net::ConnectionWrapper, GameEngine> games_;
+    std::vector<tetriz::proto::ReplayPlayer> departed_;
+    // Held by the tick worker and the event loop for everything that touches games_, the engines
+    // record their inputs in the order they apply them only while it is held
+    std::mutex mutex_;
+    // Set when players joined or left since the last broadcast, their ids have shifted
+    bool roster_changed_ = true;
     std::jthread worker_ = {};
     std::atomic<bool> run_ = true;
     TimePoint start_time_ = TimePoint::max();
@@ -110,9 +131,11 @@ private:
                 std::this_thread::sleep_until(start_time_ + tick);
 
                 log_trace("room #{}: tick", room_id_);
+                const auto lock = std::scoped_lock(mutex_);
 
                 if (start_time_ < Clock::now())
-                    std::ranges::for_each(games_ | std::views::values, &GameEngine::tick);
+                    for (auto& engine : games_ | std::views::values)
+                        engine.tick(elapsed());
 
                 std::ranges::for_each(games_ | std::views::keys, [this](const auto& client){
                     client.write(
@@ -125,12 +148,55 @@ private:
         });
     }
 
+    // Called with mutex_ held, as are the helpers below
+    void play(net::ConnectionWrapper client, std::span<const tetriz::proto::Move> moves)
+    {
+        if (!games_.contains(client))
+        {
+            log_debug("Expected Hola");
+            client.close();
+            return;
+        }
+
+        if (start_time_ > Clock::now())
+        {
+            log_trace("Won't notify, game has not started yet");
+            return;
+        }
+
+        games_
+            .at(client.descriptor())
+            .actions(moves, elapsed());
+
+        //notify_move(client);
+        notify_tick();
+    }
+
+    auto elapsed() const -> Duration
+    {
+        return std::chrono::duration_cast<Duration>(Clock::now() - start_time_);
+    }
+
+    // Players are stored in the order they left, all of them started from the room seed.
+    // Replaying every game for its keyframes takes a while, one saver shared by all rooms does it.
+    void save_replay()
+    {
+        if (!replay_directory)
+            return;
+
+        static auto saver = ReplaySaver();
+
+        const auto path = *replay_directory / std::format("room-{}-{}.tzr", room_id_, room_seed_);
+        saver.save(room_id_, { .seed = room_seed_, .players = std::exchange(departed_, {}) }, path);
+    }
+
     void add_player(net::ConnectionWrapper player)
     {
         games_.emplace(
                 std::piecewise_construct,
                 std::forward_as_tuple(player),
                 std::forward_as_tuple(room_seed_));
+        roster_changed_ = true;
 
         if (games_.size() == room_size_)
             start();
@@ -151,18 +217,24 @@ private:
         }
     }
 
+    // Clients keep the last state they received, so only games that emitted events are sent again.
+    // Player ids are positions in games_, after a join or leave every game goes out under its new id.
     void notify_tick()
     {
+        const auto resend = std::exchange(roster_changed_, false);
+
         for (const auto& current_sock : games_ | std::views::keys)
         {
             auto id = uint16_t{0};
             for (const auto& [another_sock, engine] : games_)
             {
-                if (current_sock.descriptor() == another_sock.descriptor())
-                    current_sock.write(tetriz::proto::serialize_game(0, engine.game()));
-                else
-                    current_sock.write(tetriz::proto::serialize_game(++id, engine.game()));
+                const auto player_id = current_sock.descriptor() == another_sock.descriptor() ? 0 : ++id;
+
+                if (resend || engine.changed())
+                    current_sock.write(tetriz::proto::serialize_game(player_id, engine.game()));
             }
         }
+
+        std::ranges::for_each(games_ | std::views::values, &GameEngine::flush);
     }
 };
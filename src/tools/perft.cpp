@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <print>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "engine/placements.hpp"
+
+
+struct Configuration
+{
+    uint32_t seed;
+    size_t depth;
+    size_t threads;
+    bool swap;
+};
+
+// Open addressed set of board hashes, the keys are Zobrist hashes already so their low bits are the slot.
+// The empty board hashes to 0, which also marks free slots, so it is tracked on its own.
+class BoardSet
+{
+public:
+    void insert(uint64_t key)
+    {
+        if (key == 0)
+        {
+            size_ += !has_empty_;
+            has_empty_ = true;
+            return;
+        }
+
+        if (2 * (size_ + 1) > slots_.size())
+            grow();
+
+        size_ += place(slots_, key);
+    }
+
+    auto contains(uint64_t key) const -> bool
+    {
+        if (key == 0)
+            return has_empty_;
+
+        for (auto slot = key; !slots_.empty(); ++slot)
+        {
+            const auto stored = slots_[slot & (slots_.size() - 1)];
+            if (stored == key)
+                return true;
+            if (stored == 0)
+                return false;
+        }
+
+        return false;
+    }
+
+    void merge(const BoardSet& other)
+    {
+        if (other.has_empty_)
+            insert(0);
+
+        for (const auto key : other.slots_)
+            if (key != 0)
+                insert(key);
+    }
+
+    auto size() const -> size_t { return size_; }
+
+    auto operator==(const BoardSet& other) const -> bool
+    {
+        return size_ == other.size_
+            && (!other.has_empty_ || has_empty_)
+            && std::ranges::all_of(other.slots_, [this](uint64_t key) { return key == 0 || contains(key); });
+    }
+
+private:
+    std::vector<uint64_t> slots_;
+    size_t size_ = 0;
+    bool has_empty_ = false;
+
+    // Returns whether the key was new
+    static auto place(std::vector<uint64_t>& slots, uint64_t key) -> bool
+    {
+        for (auto slot = key;; ++slot)
+        {
+            auto& stored = slots[slot & (slots.size() - 1)];
+            if (stored == key)
+                return false;
+            if (stored == 0)
+            {
+                stored = key;
+                return true;
+            }
+        }
+    }
+
+    void grow()
+    {
+        auto slots = std::vector<uint64_t>(std::max(slots_.size() * 2, 1uz << 16));
+        for (const auto key : slots_)
+            if (key != 0)
+                place(slots, key);
+
+        slots_ = std::move(slots);
+    }
+};
+
+struct PerftResult
+{
+    uint64_t nodes = 0;
+    BoardSet boards;
+
+    void merge(PerftResult&& other)
+    {
+        nodes += other.nodes;
+        boards.merge(other.boards);
+    }
+};
+
+auto parse(int argc, char** argv)
+{
+    auto program = argparse::ArgumentParser("tetriz_perft", "0.0.0");
+    auto configuration = Configuration{};
+
+    program.add_argument("depth")
+        .help("number of pieces to place")
+        .default_value<size_t>(3)
+        .scan<'i', size_t>()
+        .store_into(configuration.depth);
+
+    program.add_argument("--seed")
+        .help("bag seed")
+        .default_value<uint32_t>(0)
+        .scan<'i', uint32_t>()
+        .store_into(configuration.seed);
+
+    program.add_argument("--threads")
+        .help("worker threads for the parallel run")
+        .default_value<size_t>(std::thread::hardware_concurrency())
+        .scan<'i', size_t>()
+        .store_into(configuration.threads);
+
+    program.add_argument("--swap")
+        .help("also branch on swapping the current piece")
+        .flag()
+        .store_into(configuration.swap);
+
+    program.parse_args(argc, argv);
+
+    return configuration;
+}
+
+// Every game reachable by placing the current piece, optionally after a swap
+auto children(const tetriz::Game& game, bool swap) -> std::vector<tetriz::Game>
+{
+    auto result = std::vector<tetriz::Game>{};
+    auto placements = tetriz::PlacementList{};
+
+    const auto expand = [&](const tetriz::Game& parent) {
+        find_placements(parent.occupancy(), parent.current(), placements);
+        for (const auto& placement : placements)
+        {
+            auto child = parent;
+            child.place(placement);
+            result.push_back(child);
+        }
+    };
+
+    expand(game);
+
+    if (swap)
+    {
+        auto swapped = game;
+        swapped.swap();
+        if (swapped.current().shape != game.current().shape)
+            expand(swapped);
+    }
+
+    return result;
+}
+
+// What one level of the search works in, reused by every node at that depth so the
+// walk itself allocates nothing and the timing follows the engine
+struct Frame
+{
+    tetriz::PlacementList placements;
+    tetriz::Game swapped = tetriz::Game(0);
+    tetriz::Game child = tetriz::Game(0);
+};
+
+void perft(const tetriz::Game& game, size_t depth, bool swap, std::span<Frame> frames, PerftResult& result)
+{
+    if (depth == 0 || game.finished())
+    {
+        ++result.nodes;
+        result.boards.insert(game.occupancy().hash());
+        return;
+    }
+
+    auto& frame = frames[depth - 1];
+
+    const auto expand = [&](const tetriz::Game& parent) {
+        find_placements(parent.occupancy(), parent.current(), frame.placements);
+        for (const auto& placement : frame.placements)
+        {
+            frame.child = parent;
+            frame.child.place(placement);
+            perft(frame.child, depth - 1, swap, frames, result);
+        }
+    };
+
+    expand(game);
+
+    if (swap)
+    {
+        frame.swapped = game;
+        frame.swapped.swap();
+        if (frame.swapped.current().shape != game.current().shape)
+            expand(frame.swapped);
+    }
+}
+
+void perft(const tetriz::Game& game, size_t depth, bool swap, PerftResult& result)
+{
+    auto frames = std::vector<Frame>(depth);
+    perft(game, depth, swap, frames, result);
+}
+
+// Root subtrees are handed out to the workers one at a time
+auto perft_parallel(const tetriz::Game& game, size_t depth, bool swap, size_t threads) -> PerftResult
+{
+    const auto roots = children(game, swap);
+    auto next = std::atomic<size_t>{0};
+    auto results = std::vector<PerftResult>(threads);
+
+    {
+        auto workers = std::vector<std::jthread>{};
+        for (auto& result : results)
+            workers.emplace_back([&] {
+                auto frames = std::vector<Frame>(depth);
+                for (auto index = next++; index < roots.size(); index = next++)
+                    perft(roots[index], depth - 1, swap, frames, result);
+            });
+    }
+
+    auto total = PerftResult{};
+    for (auto& result : results)
+        total.merge(std::move(result));
+
+    return total;
+}
+
+void report(std::string_view label, const PerftResult& result, std::chrono::duration<double> elapsed)
+{
+    std::println("{:>10}: {} nodes, {} distinct boards, {:.3f} s, {:.0f} nodes/s",
+        label, result.nodes, result.boards.size(), elapsed.count(), result.nodes / elapsed.count());
+}
+
+auto main(int argc, char** argv) -> int
+{
+    const auto config = parse(argc, argv);
+    const auto game = tetriz::Game(config.seed);
+
+    const auto timed = [](auto&& run) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = run();
+        return std::pair(std::move(result), std::chrono::steady_clock::now() - start);
+    };
+
+    const auto [single, single_time] = timed([&] {
+        auto result = PerftResult{};
+        perft(game, config.depth, config.swap, result);
+        return result;
+    });
+    report("1 thread", single, single_time);
+
+    if (config.depth == 0 || config.threads < 2)
+        return 0;
+
+    const auto [parallel, parallel_time] = timed([&] {
+        return perft_parallel(game, config.depth, config.swap, config.threads);
+    });
+    report(std::format("{} threads", config.threads), parallel, parallel_time);
+
+    return parallel.nodes == single.nodes && parallel.boards == single.boards ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include <chrono>
+#include <fstream>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "proto/replay.hpp"
+
+
+struct Configuration
+{
+    std::vector<std::string> files;
+    size_t repeat;
+    std::optional<int32_t> seek;
+};
+
+auto parse(int argc, char** argv)
+{
+    auto program = argparse::ArgumentParser("tetriz_replay", "0.0.0");
+    auto configuration = Configuration{};
+
+    program.add_argument("files")
+        .help("replays to play back")
+        .nargs(argparse::nargs_pattern::at_least_one)
+        .store_into(configuration.files);
+
+    program.add_argument("--repeat")
+        .help("play every replay this many times, for timing")
+        .default_value<size_t>(1)
+        .scan<'i', size_t>()
+        .store_into(configuration.repeat);
+
+    program.add_argument("--seek")
+        .help("also show every player at this time, in hundredths of a second")
+        .scan<'i', int32_t>();
+
+    program.parse_args(argc, argv);
+
+    configuration.seek = program.present<int32_t>("--seek");
+
+    configuration.repeat = std::max(configuration.repeat, 1uz);
+
+    return configuration;
+}
+
+// Plays one player like simulate() and compares every keyframe with the state the inputs reach on
+// the way, a snapshot of anything else would make seeks lie
+auto simulate_checking_keyframes(const std::string& file, const tetriz::proto::Replay& replay, size_t player, bool& matched) -> tetriz::Game
+{
+    const auto& recording = replay.players[player];
+    auto game = tetriz::Game(replay.seed);
+    auto keyframe = recording.keyframes.begin();
+
+    for (const auto [index, input] : recording.inputs | std::views::enumerate)
+    {
+        game.apply(input.move);
+
+        if (keyframe == recording.keyframes.end() || keyframe->input_index != static_cast<size_t>(index) + 1)
+            continue;
+
+        if (tetriz::Game(keyframe->snapshot).hash() != game.hash())
+        {
+            std::println("{}: player {} keyframe at input {} does not match the inputs", file, player, keyframe->input_index);
+            matched = false;
+        }
+        ++keyframe;
+    }
+
+    return game;
+}
+
+// Plays every player of the replay and compares the final states, the first round checks the
+// keyframes along the way. Returns whether all of them matched.
+auto check(const std::string& file, const tetriz::proto::Replay& replay, size_t repeat) -> bool
+{
+    auto inputs = 0uz;
+    auto matched = true;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto round = 0uz; round < repeat; ++round)
+        for (auto player = 0uz; player < replay.players.size(); ++player)
+        {
+            const auto game = round == 0
+                ? simulate_checking_keyframes(file, replay, player, matched)
+                : tetriz::proto::simulate(replay, player);
+            inputs += replay.players[player].inputs.size();
+
+            if (round == 0 && game.hash() != replay.players[player].final_hash)
+            {
+                std::println("{}: player {} ends in {:016x}, the recording says {:016x}",
+                    file, player, game.hash(), replay.players[player].final_hash);
+                matched = false;
+            }
+        }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    std::println("{}: {} players, {} inputs, {}, {:.0f} inputs/s",
+        file, replay.players.size(), inputs / repeat, matched ? "ok" : "MISMATCH", inputs / elapsed.count());
+
+    return matched;
+}
+
+void show(const std::string& file, const tetriz::proto::Replay& replay, Duration timestamp)
+{
+    for (auto player = 0uz; player < replay.players.size(); ++player)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const auto game = tetriz::proto::seek(replay, player, timestamp);
+        const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+        std::println("{}: player {} at {}: score {}, {}, hash {:016x}, seek took {:.1f} us",
+            file, player, timestamp.count(), game.score(), game.finished() ? "finished" : "playing", game.hash(), elapsed.count());
+    }
+}
+
+auto main(int argc, char** argv) -> int
+{
+    const auto config = parse(argc, argv);
+    auto failed = 0uz;
+
+    for (const auto& file : config.files)
+    {
+        auto input = std::ifstream(file, std::ios::binary);
+        const auto replay = tetriz::proto::read_replay(input);
+
+        if (!replay)
+        {
+            std::println("{}: not a replay", file);
+            ++failed;
+        }
+        else if (replay->engine != tetriz::proto::engine_version)
+        {
+            std::println("{}: recorded by engine version {}, this is {}", file, replay->engine, tetriz::proto::engine_version);
+            ++failed;
+        }
+        else
+        {
+            if (!check(file, *replay, config.repeat))
+                ++failed;
+
+            if (config.seek)
+                show(file, *replay, Duration(*config.seek));
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
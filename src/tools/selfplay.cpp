@@ -0,0 +1,175 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <print>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "bot/bot.hpp"
+#include "bot/dataset.hpp"
+#include "engine/game.hpp"
+
+
+struct Configuration
+{
+    std::string output;
+    size_t games;
+    size_t threads;
+    uint32_t seed;
+    size_t max_pieces;
+    size_t depth;
+    size_t beam_width;
+    size_t buffer_records;
+};
+
+auto parse(int argc, char** argv)
+{
+    auto program = argparse::ArgumentParser("tetriz_selfplay", "0.0.0");
+    auto configuration = Configuration{};
+
+    program.add_argument("output")
+        .help("dataset file to write")
+        .store_into(configuration.output);
+
+    program.add_argument("--games")
+        .help("number of games to play")
+        .default_value<size_t>(100)
+        .scan<'i', size_t>()
+        .store_into(configuration.games);
+
+    program.add_argument("--threads")
+        .help("games played at the same time")
+        .default_value<size_t>(std::max(1u, std::thread::hardware_concurrency()))
+        .scan<'i', size_t>()
+        .store_into(configuration.threads);
+
+    program.add_argument("--seed")
+        .help("seed of the first game, the others follow it")
+        .default_value<uint32_t>(0)
+        .scan<'i', uint32_t>()
+        .store_into(configuration.seed);
+
+    program.add_argument("--max-pieces")
+        .help("end a game after this many pieces even if it is not topped out")
+        .default_value<size_t>(1000)
+        .scan<'i', size_t>()
+        .store_into(configuration.max_pieces);
+
+    program.add_argument("--depth")
+        .help("bot search depth")
+        .default_value<size_t>(2)
+        .scan<'i', size_t>()
+        .store_into(configuration.depth);
+
+    program.add_argument("--beam-width")
+        .help("bot beam width")
+        .default_value<size_t>(8)
+        .scan<'i', size_t>()
+        .store_into(configuration.beam_width);
+
+    program.add_argument("--buffer")
+        .help("records every thread collects before it writes them out")
+        .default_value<size_t>(1 << 14)
+        .scan<'i', size_t>()
+        .store_into(configuration.buffer_records);
+
+    program.parse_args(argc, argv);
+
+    configuration.threads = std::max(configuration.threads, 1uz);
+    configuration.buffer_records = std::max(configuration.buffer_records, 1uz);
+
+    return configuration;
+}
+
+// Appends whole buffers, the lock is taken once per buffer rather than once per record
+class DatasetWriter
+{
+public:
+    explicit DatasetWriter(const std::string& path)
+        : output_(path, std::ios::binary | std::ios::trunc)
+    {
+        write_header();
+    }
+
+    void append(std::span<const tetriz::bot::DatasetRecord> records)
+    {
+        const auto lock = std::scoped_lock(mutex_);
+        output_.write(reinterpret_cast<const char*>(records.data()), records.size_bytes());
+        count_ += records.size();
+    }
+
+    // Puts the final count into the header, returns whether everything reached the file
+    auto finish() -> bool
+    {
+        output_.seekp(0);
+        write_header();
+        output_.flush();
+
+        return static_cast<bool>(output_);
+    }
+
+    auto count() const -> uint64_t { return count_; }
+
+private:
+    void write_header()
+    {
+        const auto header = tetriz::bot::DatasetHeader{ .record_count = count_ };
+        output_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    std::ofstream output_;
+    std::mutex mutex_;
+    uint64_t count_ = 0;
+};
+
+auto main(int argc, char** argv) -> int
+{
+    const auto config = parse(argc, argv);
+
+    auto writer = DatasetWriter(config.output);
+    auto next = std::atomic<size_t>{0};
+
+    // The game threads only wait on the searches, the pool does the work
+    auto pool = ThreadPool(config.threads);
+    const auto bot = tetriz::bot::Bot(pool, {}, { .depth = config.depth, .beam_width = config.beam_width });
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        auto workers = std::vector<std::jthread>{};
+        for (auto thread = 0uz; thread < std::min(config.threads, config.games); ++thread)
+            workers.emplace_back([&] {
+                auto buffer = std::vector<tetriz::bot::DatasetRecord>{};
+                auto game = std::vector<tetriz::bot::DatasetRecord>{};
+                buffer.reserve(config.buffer_records);
+
+                for (auto index = next++; index < config.games; index = next++)
+                {
+                    tetriz::bot::self_play(bot, static_cast<uint32_t>(config.seed + index), config.max_pieces, game);
+                    buffer.insert(buffer.end(), game.begin(), game.end());
+
+                    if (buffer.size() >= config.buffer_records)
+                    {
+                        writer.append(buffer);
+                        buffer.clear();
+                    }
+                }
+
+                writer.append(buffer);
+            });
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    if (!writer.finish())
+    {
+        std::println("could not write {}", config.output);
+        return 1;
+    }
+
+    std::println("{} games, {} records ({} MB) in {:.3f} s: {:.0f} records/s",
+        config.games, writer.count(), writer.count() * sizeof(tetriz::bot::DatasetRecord) >> 20,
+        elapsed.count(), writer.count() / elapsed.count());
+}
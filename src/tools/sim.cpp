@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <numeric>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "bot/bot.hpp"
+#include "engine/game.hpp"
+#include "engine/random.hpp"
+
+
+struct Configuration
+{
+    size_t games;
+    size_t threads;
+    uint32_t seed;
+    size_t max_pieces;
+    std::string policy;
+    size_t depth;
+    size_t beam_width;
+};
+
+// The score of a game is its line count, so lines stands for both
+struct GameResult
+{
+    uint64_t inputs = 0;
+    uint64_t pieces = 0;
+    uint64_t lines = 0;
+};
+
+auto parse(int argc, char** argv)
+{
+    auto program = argparse::ArgumentParser("tetriz_sim", "0.0.0");
+    auto configuration = Configuration{};
+
+    program.add_argument("--games")
+        .help("number of games to play")
+        .default_value<size_t>(1000)
+        .scan<'i', size_t>()
+        .store_into(configuration.games);
+
+    program.add_argument("--threads")
+        .help("games played at the same time")
+        .default_value<size_t>(std::max(1u, std::thread::hardware_concurrency()))
+        .scan<'i', size_t>()
+        .store_into(configuration.threads);
+
+    program.add_argument("--seed")
+        .help("seed of the first game, the others follow it")
+        .default_value<uint32_t>(0)
+        .scan<'i', uint32_t>()
+        .store_into(configuration.seed);
+
+    program.add_argument("--max-pieces")
+        .help("end a game after this many pieces even if it is not topped out")
+        .default_value<size_t>(10000)
+        .scan<'i', size_t>()
+        .store_into(configuration.max_pieces);
+
+    program.add_argument("--policy")
+        .help("what plays the games")
+        .default_value<std::string>("random")
+        .choices("random", "bot")
+        .store_into(configuration.policy);
+
+    program.add_argument("--depth")
+        .help("bot search depth")
+        .default_value<size_t>(1)
+        .scan<'i', size_t>()
+        .store_into(configuration.depth);
+
+    program.add_argument("--beam-width")
+        .help("bot beam width")
+        .default_value<size_t>(8)
+        .scan<'i', size_t>()
+        .store_into(configuration.beam_width);
+
+    program.parse_args(argc, argv);
+
+    configuration.threads = std::max(configuration.threads, 1uz);
+
+    return configuration;
+}
+
+// A policy feeds one game, every step is one input or one whole placement
+template <typename P>
+concept Policy = requires(P& policy, tetriz::Game& game) {
+    policy.step(game);
+};
+
+// Uniformly random inputs, swaps and drops included
+class RandomPolicy
+{
+public:
+    explicit RandomPolicy(uint32_t seed) : generator_(seed) {}
+
+    void step(tetriz::Game& game)
+    {
+        const auto count = static_cast<uint32_t>(magic_enum::enum_count<tetriz::Move>());
+        game.apply(static_cast<tetriz::Move>(tetriz::uniform_below(generator_, count)));
+    }
+
+private:
+    tetriz::Pcg32 generator_;
+};
+
+class BotPolicy
+{
+public:
+    explicit BotPolicy(const tetriz::bot::Bot& bot) : bot_(bot) {}
+
+    void step(tetriz::Game& game)
+    {
+        if (const auto decision = bot_.decide(game); decision)
+            tetriz::bot::apply(game, *decision);
+    }
+
+private:
+    const tetriz::bot::Bot& bot_;
+};
+
+template <Policy P>
+auto play(uint32_t seed, size_t max_pieces, P policy) -> GameResult
+{
+    auto game = tetriz::Game(seed);
+    auto storage = std::array<tetriz::GameEvent, 32>{};
+    auto events = tetriz::GameEventBuffer(storage);
+    game.set_event_buffer(&events);
+
+    auto result = GameResult{};
+    while (!game.finished() && result.pieces < max_pieces)
+    {
+        policy.step(game);
+        ++result.inputs;
+
+        for (const auto& event : events.events())
+        {
+            if (event.type == tetriz::GameEventType::Locked)
+                ++result.pieces;
+            else if (event.type == tetriz::GameEventType::Cleared)
+                result.lines += std::popcount(event.rows);
+        }
+
+        events.clear();
+    }
+
+    return result;
+}
+
+// Games are handed out to the workers one at a time, game i always gets seed + i
+template <typename MakePolicy>
+auto simulate(const Configuration& config, MakePolicy&& make_policy) -> std::vector<GameResult>
+{
+    auto results = std::vector<GameResult>(config.games);
+    auto next = std::atomic<size_t>{0};
+
+    auto workers = std::vector<std::jthread>{};
+    for (auto thread = 0uz; thread < std::min(config.threads, config.games); ++thread)
+        workers.emplace_back([&] {
+            for (auto index = next++; index < results.size(); index = next++)
+            {
+                const auto seed = static_cast<uint32_t>(config.seed + index);
+                results[index] = play(seed, config.max_pieces, make_policy(seed));
+            }
+        });
+
+    workers.clear();
+    return results;
+}
+
+void report_distribution(std::string_view label, const std::vector<GameResult>& results, uint64_t GameResult::* field)
+{
+    auto values = std::vector<uint64_t>{};
+    for (const auto& result : results)
+        values.push_back(result.*field);
+    std::ranges::sort(values);
+
+    const auto percentile = [&](size_t p) { return values[(values.size() - 1) * p / 100]; };
+    const auto mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+
+    std::println("{:>8}: mean {:.1f}, min {}, p50 {}, p90 {}, p99 {}, max {}",
+        label, mean, values.front(), percentile(50), percentile(90), percentile(99), values.back());
+}
+
+void report(const std::vector<GameResult>& results, std::chrono::duration<double> elapsed)
+{
+    const auto total = [&](uint64_t GameResult::* field) {
+        return std::accumulate(results.begin(), results.end(), uint64_t{0},
+            [field](auto sum, const auto& result) { return sum + result.*field; });
+    };
+
+    const auto seconds = elapsed.count();
+    std::println("{} games in {:.3f} s: {:.1f} games/s, {:.0f} pieces/s, {:.0f} inputs/s",
+        results.size(), seconds, results.size() / seconds,
+        total(&GameResult::pieces) / seconds, total(&GameResult::inputs) / seconds);
+
+    report_distribution("inputs", results, &GameResult::inputs);
+    report_distribution("pieces", results, &GameResult::pieces);
+    report_distribution("lines", results, &GameResult::lines);
+}
+
+auto main(int argc, char** argv) -> int
+{
+    const auto config = parse(argc, argv);
+    if (config.games == 0)
+        return 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto results = std::vector<GameResult>{};
+
+    if (config.policy == "bot")
+    {
+        // The game threads only wait on the searches, the pool does the work
+        auto pool = ThreadPool(config.threads);
+        const auto bot = tetriz::bot::Bot(pool, {}, { .depth = config.depth, .beam_width = config.beam_width });
+        results = simulate(config, [&](uint32_t) { return BotPolicy(bot); });
+    }
+    else
+    {
+        results = simulate(config, [](uint32_t seed) { return RandomPolicy(seed); });
+    }
+
+    report(results, std::chrono::steady_clock::now() - start);
+}
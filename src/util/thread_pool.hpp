@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// Every worker owns a deque, it works LIFO on its own tasks and steals FIFO from the others when it runs dry
+class ThreadPool
+{
+    using Task = std::move_only_function<void()>;
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+public:
+    explicit ThreadPool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        : queues_(std::make_unique<Queue[]>(threads))
+        , size_(threads)
+    {
+        workers_.reserve(threads);
+        for (auto index = 0uz; index < threads; ++index)
+            workers_.emplace_back([this, index](std::stop_token stop) { run(index, stop); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    ~ThreadPool()
+    {
+        for (auto& worker : workers_)
+            worker.request_stop();
+
+        wake_.notify_all();
+    }
+
+    auto size() const -> size_t { return size_; }
+
+    // Tasks submitted from a worker land in that worker's own deque, the others spread round-robin
+    template <typename F>
+    auto submit(F&& function) -> std::future<std::invoke_result_t<F>>
+    {
+        auto task = std::packaged_task<std::invoke_result_t<F>()>(std::forward<F>(function));
+        auto result = task.get_future();
+
+        const auto index = on_worker() ? worker_index_ : next_queue_++ % size_;
+
+        // Counted before it is published, a worker may pop it the moment it is in the deque
+        {
+            const auto lock = std::scoped_lock(sleep_mutex_);
+            ++pending_;
+        }
+
+        {
+            const auto lock = std::scoped_lock(queues_[index].mutex);
+            queues_[index].tasks.emplace_back(std::move(task));
+        }
+        wake_.notify_one();
+
+        return result;
+    }
+
+    // Waits for a result of this pool and runs queued tasks in the meantime. Tasks that wait on
+    // other tasks have to use this instead of future::get, with get every worker can end up
+    // blocked on work that no thread is left to run.
+    template <typename T>
+    auto wait(std::future<T>& result) -> T
+    {
+        const auto index = on_worker() ? worker_index_ : 0;
+
+        while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (auto task = pop(index); task)
+                task();
+            else if (on_worker())
+                std::this_thread::yield();
+            else
+                // The workers can finish the rest, they never block on it
+                result.wait();
+        }
+
+        return result.get();
+    }
+
+private:
+    auto on_worker() const -> bool
+    {
+        return worker_index_ < size_ && current_pool_ == this;
+    }
+
+    void run(size_t index, std::stop_token stop)
+    {
+        worker_index_ = index;
+        current_pool_ = this;
+
+        while (!stop.stop_requested())
+        {
+            if (auto task = pop(index); task)
+            {
+                task();
+                continue;
+            }
+
+            auto lock = std::unique_lock(sleep_mutex_);
+            wake_.wait(lock, stop, [this] { return pending_ > 0; });
+        }
+    }
+
+    auto pop(size_t index) -> Task
+    {
+        for (auto offset = 0uz; offset < size_; ++offset)
+        {
+            auto& queue = queues_[(index + offset) % size_];
+            auto task = Task{};
+
+            {
+                const auto lock = std::scoped_lock(queue.mutex);
+                if (queue.tasks.empty())
+                    continue;
+
+                if (offset == 0)
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+            }
+
+            const auto lock = std::scoped_lock(sleep_mutex_);
+            --pending_;
+            return task;
+        }
+
+        return {};
+    }
+
+    inline static thread_local size_t worker_index_ = SIZE_MAX;
+    inline static thread_local const ThreadPool* current_pool_ = nullptr;
+
+    std::unique_ptr<Queue[]> queues_;
+    size_t size_;
+    std::atomic<size_t> next_queue_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable_any wake_;
+    size_t pending_ = 0;
+    std::vector<std::jthread> workers_;
+};
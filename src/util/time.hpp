@@ -2,7 +2,8 @@
 
 #include <chrono>
 
-using Clock = std::chrono::high_resolution_clock;
+// Replays require input timestamps in order, so time never comes from a clock that can step back
+using Clock = std::chrono::steady_clock;
 using TimePoint = std::chrono::time_point<Clock>;
 using Duration = std::chrono::duration<int32_t, std::centi>;
 
@@ -0,0 +1,247 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "bot/bot.hpp"
+#include "bot/transposition_table.hpp"
+
+
+namespace
+{
+    // Cell by cell definitions of the features to check the bit parallel kernels against
+    auto reference_features(const tetriz::Board& board) -> tetriz::bot::BoardFeatures
+    {
+        using tetriz::board_height;
+        using tetriz::board_width;
+
+        const auto filled = [&](int x, int y) {
+            return x < 0 || x >= int{board_width} || y >= int{board_height} || tetriz::is_occupied(board[y][x]);
+        };
+
+        auto heights = std::array<int, board_width>{};
+        auto result = tetriz::bot::BoardFeatures{};
+
+        for (auto x = 0; x < int{board_width}; ++x)
+        {
+            auto top = 0;
+            while (top < int{board_height} && !filled(x, top))
+                ++top;
+
+            heights[x] = board_height - top;
+            result.aggregate_height += heights[x];
+            result.max_height = std::max(result.max_height, heights[x]);
+
+            for (auto y = 0; y < int{board_height}; ++y)
+            {
+                result.holes += y > top && !filled(x, y);
+                result.wells += y < top && filled(x - 1, y) && filled(x + 1, y);
+                result.column_transitions += filled(x, y) != (y > 0 && filled(x, y - 1));
+            }
+            result.column_transitions += !filled(x, board_height - 1);
+        }
+
+        for (auto x = 1; x < int{board_width}; ++x)
+            result.bumpiness += std::abs(heights[x] - heights[x - 1]);
+
+        for (auto y = 0; y < int{board_height}; ++y)
+            for (auto x = -1; x < int{board_width}; ++x)
+                result.row_transitions += filled(x, y) != filled(x + 1, y);
+
+        return result;
+    }
+
+    auto same_features(const tetriz::bot::BoardFeatures& lhs, const tetriz::bot::BoardFeatures& rhs) -> bool
+    {
+        return lhs.aggregate_height == rhs.aggregate_height
+            && lhs.holes == rhs.holes
+            && lhs.bumpiness == rhs.bumpiness
+            && lhs.max_height == rhs.max_height
+            && lhs.row_transitions == rhs.row_transitions
+            && lhs.column_transitions == rhs.column_transitions
+            && lhs.wells == rhs.wells;
+    }
+}
+
+
+TEST(Bot, FeaturesOfDroppedPiece)
+{
+    auto game = tetriz::Game(3);
+
+    // An O dropped onto the floor at the left edge
+    auto board = game.occupancy();
+    tetriz::project_on_board(board, game.ghost(tetriz::Tetromino{ .shape = tetriz::TetrominoShape::O }));
+    const auto features = tetriz::bot::features(board);
+
+    EXPECT_EQ(features.aggregate_height, 4);
+    EXPECT_EQ(features.holes, 0);
+    EXPECT_EQ(features.bumpiness, 2);
+    EXPECT_EQ(features.max_height, 2);
+}
+
+TEST(Bot, SurvivesAndClearsLines)
+{
+    auto pool = ThreadPool(2);
+    const auto bot = tetriz::bot::Bot(pool, {}, { .depth = 2, .beam_width = 4 });
+    auto game = tetriz::Game(11);
+
+    for (auto piece = 0; piece < 120; ++piece)
+    {
+        const auto decision = bot.decide(game);
+        ASSERT_TRUE(decision);
+
+        // Every other piece goes through the inputs a network client would send
+        if (piece % 2)
+        {
+            const auto moves = tetriz::bot::moves(game, *decision);
+            ASSERT_TRUE(moves);
+
+            auto expected = game;
+            tetriz::bot::apply(expected, *decision);
+            game.apply(*moves);
+            ASSERT_EQ(game.hash(), expected.hash());
+        }
+        else
+        {
+            tetriz::bot::apply(game, *decision);
+        }
+
+        ASSERT_FALSE(game.finished());
+    }
+
+    EXPECT_GT(game.score(), 30);
+}
+
+TEST(Bot, DecisionDoesNotDependOnThreadCount)
+{
+    auto single = ThreadPool(1);
+    auto multi = ThreadPool(3);
+    const auto options = tetriz::bot::SearchOptions{ .depth = 2, .beam_width = 4 };
+    const auto lhs = tetriz::bot::Bot(single, {}, options);
+    const auto rhs = tetriz::bot::Bot(multi, {}, options);
+    auto game = tetriz::Game(5);
+
+    for (auto piece = 0; piece < 20; ++piece)
+    {
+        const auto left = lhs.decide(game);
+        const auto right = rhs.decide(game);
+        ASSERT_TRUE(left && right);
+        ASSERT_EQ(left->swap, right->swap);
+        ASSERT_EQ(left->placement.coordinates.x, right->placement.coordinates.x);
+        ASSERT_EQ(left->placement.coordinates.y, right->placement.coordinates.y);
+        ASSERT_EQ(left->placement.rotation, right->placement.rotation);
+        tetriz::bot::apply(game, *left);
+    }
+}
+
+TEST(Bot, SharedBoardScoresMatchFreshEvaluation)
+{
+    // A one entry table misses nearly always, the default one hits for about half the boards
+    auto pool = ThreadPool(2);
+    const auto cached = tetriz::bot::Bot(pool, {}, { .depth = 3, .beam_width = 4 });
+    const auto fresh = tetriz::bot::Bot(pool, {}, { .depth = 3, .beam_width = 4, .table_size = 1 });
+    auto game = tetriz::Game(12);
+
+    for (auto piece = 0; piece < 15; ++piece)
+    {
+        const auto left = cached.decide(game);
+        const auto right = fresh.decide(game);
+        ASSERT_TRUE(left && right);
+        ASSERT_EQ(left->swap, right->swap);
+        ASSERT_EQ(left->placement.coordinates.x, right->placement.coordinates.x);
+        ASSERT_EQ(left->placement.coordinates.y, right->placement.coordinates.y);
+        ASSERT_EQ(left->placement.rotation, right->placement.rotation);
+        tetriz::bot::apply(game, *left);
+    }
+}
+
+TEST(Bot, DecidesFromTasksOfItsOwnPool)
+{
+    // Every worker is busy in decide() at once, each one has to run the searches it is waiting on
+    auto pool = ThreadPool(2);
+    const auto bot = tetriz::bot::Bot(pool, {}, { .depth = 2, .beam_width = 4 });
+    const auto game = tetriz::Game(6);
+    const auto expected = bot.decide(game);
+
+    auto decisions = std::vector<std::future<std::optional<tetriz::bot::Decision>>>{};
+    for (auto task = 0; task < 4; ++task)
+        decisions.push_back(pool.submit([&] { return bot.decide(game); }));
+
+    // Not a worker, so it leaves all of the work to the pool
+    for (auto& decision : decisions)
+    {
+        const auto result = decision.get();
+        ASSERT_TRUE(result && expected);
+        EXPECT_EQ(result->placement.coordinates.x, expected->placement.coordinates.x);
+        EXPECT_EQ(result->placement.rotation, expected->placement.rotation);
+    }
+}
+
+TEST(Bot, BatchFeaturesMatchCellByCellReference)
+{
+    auto batch = tetriz::bot::BoardBatch<16>{};
+    auto boards = std::array<tetriz::Board, 16>{};
+
+    // Random drops build ragged stacks with holes, every lane gets a different game
+    for (auto [index, board] : boards | std::views::enumerate)
+    {
+        auto game = tetriz::Game(100 + index);
+        for (auto step = 0; step < 40 * index && !game.finished(); ++step)
+        {
+            game.move(step % 3 == 0 ? tetriz::Direction::Left : tetriz::Direction::Right);
+            if (step % 5 == 0)
+                game.rotate();
+            if (step % 4 == 0)
+                game.drop();
+        }
+
+        board = game.board();
+        batch.load(index, board);
+    }
+
+    const auto simd = tetriz::bot::features(batch);
+    const auto scalar = tetriz::bot::features_scalar(batch);
+    for (auto index = 0uz; index < boards.size(); ++index)
+    {
+        const auto expected = reference_features(boards[index]);
+        EXPECT_TRUE(same_features(simd[index], expected)) << "board " << index;
+        EXPECT_TRUE(same_features(scalar[index], expected)) << "board " << index;
+        EXPECT_TRUE(same_features(tetriz::bot::features(tetriz::BitBoard(boards[index])), expected));
+    }
+}
+
+TEST(Bot, TranspositionTableNeverReturnsTornEntries)
+{
+    // Every value is derived from its key, a hit with any other value would be a torn read
+    struct Entry
+    {
+        uint32_t check;
+        float value;
+    };
+
+    auto table = tetriz::bot::TranspositionTable<Entry>(1024);
+    const auto entry_of = [](uint64_t key) { return Entry{ static_cast<uint32_t>(key * 7), static_cast<float>(key % 1000) }; };
+
+    {
+        auto threads = std::vector<std::jthread>{};
+        for (auto thread = 0u; thread < 4; ++thread)
+            threads.emplace_back([&, thread] {
+                auto random = tetriz::Pcg32(thread);
+                for (auto i = 0; i < 200'000; ++i)
+                {
+                    const auto key = uint64_t{random()} << 32 | random();
+                    if (i % 2)
+                        table.store(key, entry_of(key));
+                    else if (const auto entry = table.probe(key); entry)
+                        ASSERT_EQ(entry->check, entry_of(key).check);
+                }
+            });
+    }
+
+    const auto key = uint64_t{0x1234'5678'9ABC};
+    EXPECT_FALSE(table.probe(key));
+    table.store(key, entry_of(key));
+    ASSERT_TRUE(table.probe(key));
+    EXPECT_EQ(table.probe(key)->value, entry_of(key).value);
+    table.clear();
+    EXPECT_FALSE(table.probe(key));
+}
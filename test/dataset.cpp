@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bot/dataset.hpp"
+
+
+namespace
+{
+    auto played_records(uint32_t seed, size_t pieces, tetriz::bot::Weights weights = {}) -> std::vector<tetriz::bot::DatasetRecord>
+    {
+        auto pool = ThreadPool(1);
+        const auto bot = tetriz::bot::Bot(pool, weights, { .depth = 1 });
+        auto records = std::vector<tetriz::bot::DatasetRecord>{};
+        tetriz::bot::self_play(bot, seed, pieces, records);
+        return records;
+    }
+
+    auto dataset_file(std::span<const tetriz::bot::DatasetRecord> records, tetriz::bot::DatasetHeader header) -> std::vector<std::byte>
+    {
+        auto file = std::vector<std::byte>(sizeof(header) + records.size_bytes());
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + sizeof(header), records.data(), records.size_bytes());
+        return file;
+    }
+}
+
+
+TEST(Dataset, RecordsReplayTheGameAndCarryItsOutcome)
+{
+    const auto records = played_records(11, 80);
+    ASSERT_EQ(records.size(), 80);
+
+    auto game = tetriz::Game(11);
+    auto lines = 0u;
+    for (const auto& record : records)
+    {
+        ASSERT_TRUE(std::ranges::equal(record.rows, game.occupancy().rows()));
+        ASSERT_EQ(record.current, game.current().shape);
+        ASSERT_EQ(record.preview, game.bag().peek<tetriz::bot::dataset_preview>());
+
+        auto placement = tetriz::Tetromino{ .rotation = record.rotation, .coordinates = { record.x, record.y } };
+        placement.shape = record.swap ? (game.swapped() ? *game.swapped() : game.bag().peek<1>()[0]) : record.current;
+        tetriz::bot::apply(game, { .swap = record.swap != 0, .placement = placement });
+        lines += record.lines;
+    }
+
+    ASSERT_EQ(lines, game.score());
+    ASSERT_EQ(records.front().lines_after, lines);
+    for (auto index = 0uz; index < records.size(); ++index)
+    {
+        ASSERT_EQ(records[index].pieces_after, records.size() - index);
+        ASSERT_FALSE(records[index].topped_out);
+    }
+}
+
+TEST(Dataset, MappedFileReadsInPlace)
+{
+    const auto records = played_records(3, 20);
+
+    const auto file = dataset_file(records, { .record_count = records.size() });
+    const auto view = tetriz::bot::dataset_records(file);
+    ASSERT_TRUE(view);
+    ASSERT_EQ(view->size(), records.size());
+    EXPECT_EQ(std::memcmp(view->data(), records.data(), records.size() * sizeof(records[0])), 0);
+
+    // A generator that did not finish leaves the count at zero, the file size tells it instead
+    const auto unfinished = dataset_file(records, {});
+    ASSERT_EQ(tetriz::bot::dataset_records(unfinished)->size(), records.size());
+
+    EXPECT_FALSE(tetriz::bot::dataset_records(dataset_file(records, { .version = 0 })));
+    EXPECT_FALSE(tetriz::bot::dataset_records(std::span(file).first(10)));
+}
+
+TEST(Dataset, GamesThatTopOutMarkEveryRecord)
+{
+    // Rewarding height stacks the pieces up until the next one cannot spawn
+    const auto records = played_records(7, 1000, { .aggregate_height = 1.0f, .lines = 0.0f, .holes = 0.0f, .bumpiness = 0.0f });
+    ASSERT_FALSE(records.empty());
+    ASSERT_LT(records.size(), 1000);
+
+    for (auto index = 0uz; index < records.size(); ++index)
+    {
+        ASSERT_EQ(records[index].topped_out, 1);
+        ASSERT_EQ(records[index].pieces_after, records.size() - index);
+    }
+}
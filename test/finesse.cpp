@@ -0,0 +1,89 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/finesse.hpp"
+#include "engine/placements.hpp"
+
+
+namespace
+{
+    // Plays the moves on a copy and checks that only the last one locks, at the target
+    auto locks_at(const tetriz::Game& game, const std::vector<tetriz::Move>& moves, const tetriz::Tetromino& target)
+    {
+        auto played = game;
+        auto expected = game;
+        expected.place(target);
+
+        for (const auto move : moves | std::views::take(moves.size() - 1))
+        {
+            played.apply(move);
+            if (played.bag().hash() != game.bag().hash())
+                return false;
+        }
+
+        played.apply(moves.back());
+        return played.hash() == expected.hash() && played.score() == expected.score();
+    }
+
+    // Reference answer from the plain search, without the open board table
+    auto searched_length(const tetriz::Game& game, const tetriz::Tetromino& target) -> size_t
+    {
+        auto tree = tetriz::detail::FinesseTree<tetriz::StandardRules>{};
+        const auto last = tree.search(game.occupancy(), game.current(), [&](const tetriz::Tetromino& state) {
+            return state.rotation == target.rotation
+                && state.coordinates.x == target.coordinates.x
+                && state.coordinates.y + game.drop_distance(state) == target.coordinates.y;
+        });
+
+        return last ? tree.path(*last).size() + 1 : 0;
+    }
+}
+
+
+TEST(Finesse, EveryPlacementIsReachedAndLocked)
+{
+    auto game = tetriz::Game(31);
+
+    for (auto piece = 0; piece < 40 && !game.finished(); ++piece)
+    {
+        const auto placements = tetriz::find_placements(game);
+        for (const auto& target : placements)
+        {
+            const auto moves = tetriz::finesse(game, target);
+            ASSERT_TRUE(moves);
+            ASSERT_TRUE(locks_at(game, *moves, target));
+            ASSERT_EQ(moves->size(), searched_length(game, target));
+        }
+
+        // Low placements first so that the stack grows into the fast path limit and past it
+        game.place(*std::ranges::max_element(placements, {}, [](const auto& placement) {
+            return placement.coordinates.y * 16 + placement.coordinates.x % 3;
+        }));
+    }
+}
+
+TEST(Finesse, OpenBoardMatchesSearch)
+{
+    for (const auto shape : magic_enum::enum_values<tetriz::TetrominoShape>())
+    {
+        const auto& table = tetriz::open_board_finesse<tetriz::StandardRules>[shape];
+        for (const auto rotation : magic_enum::enum_values<tetriz::TetrominoRotation>())
+            EXPECT_TRUE(std::ranges::any_of(table[rotation], &tetriz::detail::OpenPath::reachable));
+    }
+
+    // Straight down from the spawn is a single hard drop
+    const auto game = tetriz::Game(4);
+    const auto moves = tetriz::finesse(game, game.ghost());
+    ASSERT_TRUE(moves);
+    EXPECT_EQ(*moves, std::vector{ tetriz::Move::Drop });
+}
+
+TEST(Finesse, RejectsPlacementsThatDoNotRest)
+{
+    const auto game = tetriz::Game(4);
+    auto floating = game.ghost();
+    --floating.coordinates.y;
+
+    EXPECT_FALSE(tetriz::finesse(game, floating));
+}
@@ -0,0 +1,245 @@
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "engine/game.hpp"
+#include "engine/game_batch.hpp"
+#include "engine/placements.hpp"
+
+
+namespace
+{
+    void play(tetriz::Game& game, uint32_t seed, size_t steps)
+    {
+        auto state = seed;
+        for (auto step = 0uz; step < steps && !game.finished(); ++step)
+        {
+            state = state * 1664525u + 1013904223u;
+            switch ((state >> 24) % 6)
+            {
+                case 0: game.move(tetriz::Direction::Left); break;
+                case 1: game.move(tetriz::Direction::Right); break;
+                case 2: game.move(tetriz::Direction::Down); break;
+                case 3: game.rotate(); break;
+                case 4: game.drop(); break;
+                case 5: game.swap(); break;
+            }
+        }
+    }
+}
+
+
+TEST(Game, OccupancyMirrorsBoard)
+{
+    for (auto seed = 0u; seed < 16; ++seed)
+    {
+        auto game = tetriz::Game(seed);
+        play(game, seed, 2000);
+
+        for (auto y = 0uz; y < tetriz::board_height; ++y)
+            for (auto x = 0uz; x < tetriz::board_width; ++x)
+                ASSERT_EQ(tetriz::is_occupied(game.board()[y][x]), bool(game.occupancy().row(y) & (1u << x)));
+    }
+}
+
+TEST(Game, DropDistanceMatchesStepwiseFall)
+{
+    for (auto seed = 0u; seed < 16; ++seed)
+    {
+        auto game = tetriz::Game(seed);
+        for (auto round = 0; round < 50; ++round)
+        {
+            play(game, seed + round, 7);
+            if (game.finished())
+                break;
+
+            auto falling = tetriz::Tetromino{game.current()};
+            auto stepped = game.current();
+            ++stepped.coordinates.y;
+            while (tetriz::fits(game.occupancy(), stepped))
+            {
+                falling = stepped;
+                ++stepped.coordinates.y;
+            }
+
+            ASSERT_EQ(game.ghost().coordinates.y, falling.coordinates.y);
+        }
+    }
+}
+
+TEST(Game, RestoreRewindsToSnapshot)
+{
+    auto game = tetriz::Game(99);
+    play(game, 1, 300);
+
+    const auto snapshot = game.snapshot();
+    auto replayed = tetriz::Game(snapshot);
+
+    play(game, 2, 300);
+    play(replayed, 2, 300);
+    ASSERT_EQ(game.score(), replayed.score());
+    ASSERT_TRUE(std::ranges::equal(game.occupancy().rows(), replayed.occupancy().rows()));
+
+    game.restore(snapshot);
+    play(game, 2, 300);
+    ASSERT_EQ(game.score(), replayed.score());
+    ASSERT_TRUE(std::ranges::equal(game.occupancy().rows(), replayed.occupancy().rows()));
+    ASSERT_EQ(game.bag().peek<7>(), replayed.bag().peek<7>());
+}
+
+TEST(Game, IncrementalHashMatchesRebuiltState)
+{
+    for (auto seed = 0u; seed < 8; ++seed)
+    {
+        auto game = tetriz::Game(seed);
+
+        for (auto round = 0; round < 60 && !game.finished(); ++round)
+        {
+            play(game, seed * 100 + round, 20);
+            ASSERT_EQ(game.occupancy().hash(), tetriz::BitBoard(game.board()).hash());
+            ASSERT_EQ(game.hash(), tetriz::Game(game.snapshot()).hash());
+        }
+    }
+}
+
+TEST(Game, ViewOverlaysCurrentPiece)
+{
+    auto game = tetriz::Game(7);
+
+    for (auto round = 0; round < 40 && !game.finished(); ++round)
+    {
+        play(game, round, 15);
+        if (game.finished())
+            break;
+
+        auto projected = game.board();
+        tetriz::project_on_board(projected, game.current());
+
+        const auto view = game.view();
+        for (auto y = 0uz; y < tetriz::board_height; ++y)
+            for (auto x = 0uz; x < tetriz::board_width; ++x)
+                ASSERT_EQ(view[y][x], projected[y][x]);
+
+        auto occupancy = game.occupancy();
+        tetriz::project_on_board(occupancy, game.current());
+        ASSERT_EQ(tetriz::BitBoard(view).hash(), occupancy.hash());
+    }
+}
+
+TEST(Game, HashFollowsPieceAndSwap)
+{
+    auto game = tetriz::Game(8);
+    const auto initial = game.hash();
+
+    game.move(tetriz::Direction::Left);
+    EXPECT_NE(game.hash(), initial);
+    game.move(tetriz::Direction::Right);
+    EXPECT_EQ(game.hash(), initial);
+
+    auto swapped = game;
+    swapped.swap();
+    EXPECT_NE(swapped.hash(), initial);
+    EXPECT_NE(tetriz::Game(9).hash(), initial);
+}
+
+TEST(Game, HashTellsEmptySwapSlotFromZ)
+{
+    auto empty = tetriz::Game(8).snapshot();
+    empty.swapped = std::nullopt;
+    auto holding_z = empty;
+    holding_z.swapped = tetriz::TetrominoShape::Z;
+
+    EXPECT_NE(tetriz::Game(empty).hash(), tetriz::Game(holding_z).hash());
+    EXPECT_NE(tetriz::zobrist::swapped(std::nullopt), tetriz::zobrist::swapped(tetriz::TetrominoShape::Z));
+}
+
+TEST(Game, PieceKeysDifferForEveryShape)
+{
+    auto keys = std::set<uint64_t>{};
+    for (const auto shape : magic_enum::enum_values<tetriz::TetrominoShape>())
+        for (const auto rotation : magic_enum::enum_values<tetriz::TetrominoRotation>())
+            keys.insert(tetriz::zobrist::piece({ shape, rotation, { 9, 21 } }));
+
+    EXPECT_EQ(keys.size(), magic_enum::enum_count<tetriz::TetrominoShape>() * magic_enum::enum_count<tetriz::TetrominoRotation>());
+}
+
+TEST(Game, EmitsEventsIntoAttachedBuffer)
+{
+    auto storage = std::array<tetriz::GameEvent, 8>{};
+    auto events = tetriz::GameEventBuffer(storage);
+
+    auto game = tetriz::Game(5);
+    game.set_event_buffer(&events);
+
+    game.move(tetriz::Direction::Left);
+    const auto landing = game.ghost();
+    game.drop();
+
+    ASSERT_EQ(events.events().size(), 3);
+    ASSERT_EQ(events.events()[0].type, tetriz::GameEventType::Moved);
+    ASSERT_EQ(events.events()[1].type, tetriz::GameEventType::Locked);
+    ASSERT_EQ(events.events()[1].tetromino.coordinates.y, landing.coordinates.y);
+    ASSERT_EQ(events.events()[2].type, tetriz::GameEventType::Spawned);
+    ASSERT_EQ(events.events()[2].tetromino.shape, game.current().shape);
+
+    auto copy = game;
+    copy.drop();
+    ASSERT_EQ(events.events().size(), 3);
+}
+
+TEST(Game, ApplyBurstMatchesSingleMoves)
+{
+    using tetriz::Move;
+    constexpr auto moves = std::array{
+        Move::Left, Move::Rotate, Move::Drop, Move::Swap, Move::Right,
+        Move::Right, Move::Down, Move::Rotate, Move::Rotate, Move::Drop
+    };
+
+    auto single = tetriz::Game(11);
+    for (const auto move : moves)
+        single.apply(move);
+
+    auto burst = tetriz::Game(11);
+    auto applied = 0uz;
+    burst.apply(moves, [&](Move move, const tetriz::Game&) { ASSERT_EQ(move, moves[applied++]); });
+
+    ASSERT_EQ(applied, moves.size());
+    ASSERT_TRUE(std::ranges::equal(single.occupancy().rows(), burst.occupancy().rows()));
+    ASSERT_EQ(single.current().shape, burst.current().shape);
+}
+
+TEST(Game, NarrowRulesPlayOnFourColumns)
+{
+    using NarrowRules = tetriz::GameRules<
+        tetriz::BoardGeometry<4, 12>, tetriz::SrsKicks, tetriz::CounterRandomizer, tetriz::StandardSpawn>;
+
+    auto game = tetriz::BasicGame<NarrowRules>(17);
+    auto seeds = std::array<uint32_t, 1>{ 17 };
+    auto batch = tetriz::GameBatch<1, NarrowRules>(seeds);
+
+    ASSERT_EQ(game.current().coordinates.x, 0);
+    ASSERT_EQ(game.board().size(), 12);
+    ASSERT_EQ(game.occupancy().rows().size(), 12);
+
+    // Searches run on the narrow geometry and kick policy of the rules
+    for (const auto& placement : tetriz::find_placements(game))
+        ASSERT_TRUE(tetriz::fits(game.occupancy(), placement));
+
+    auto state = 5u;
+    for (auto step = 0; step < 2000 && !game.finished(); ++step)
+    {
+        state = state * 1664525u + 1013904223u;
+        const auto move = static_cast<tetriz::Move>((state >> 24) % 6);
+
+        game.apply(move);
+        batch.apply(0, move);
+
+        ASSERT_TRUE(std::ranges::equal(game.occupancy().rows(), decltype(game)::BitBoard(game.board()).rows()));
+        ASSERT_TRUE(std::ranges::equal(game.occupancy().rows(), batch.occupancy(0).rows()));
+        ASSERT_TRUE(std::ranges::all_of(game.occupancy().rows(), [](auto row) { return row <= 0xF; }));
+        ASSERT_EQ(game.score(), batch.score(0));
+    }
+
+    EXPECT_TRUE(game.finished());
+    EXPECT_GT(game.score(), 0);
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bot/bot.hpp"
+#include "engine/game.hpp"
+#include "engine/game_batch.hpp"
+#include "engine/random.hpp"
+
+
+TEST(GameBatch, MatchesIndependentGames)
+{
+    constexpr auto games = 16uz;
+
+    auto seeds = std::array<uint32_t, games>{};
+    std::iota(seeds.begin(), seeds.end(), 40u);
+
+    auto batch = std::make_unique<tetriz::GameBatch<games>>(seeds);
+    auto reference = std::vector<tetriz::Game>(seeds.begin(), seeds.end());
+    auto random = tetriz::Pcg32(9);
+    auto moves = std::array<tetriz::Move, games>{};
+
+    // Runs well past the first top outs, finished games keep taking input like Game does
+    for (auto step = 0; step < 3000; ++step)
+    {
+        for (auto& move : moves)
+            move = static_cast<tetriz::Move>(tetriz::uniform_below(random, 6));
+
+        batch->apply(moves);
+        for (auto game = 0uz; game < games; ++game)
+            reference[game].apply(moves[game]);
+
+        for (auto game = 0uz; game < games; ++game)
+        {
+            const auto& expected = reference[game];
+            const auto& current = batch->current(game);
+
+            ASSERT_EQ(batch->finished(game), expected.finished());
+            ASSERT_EQ(batch->score(game), expected.score());
+            ASSERT_EQ(batch->swapped(game), expected.swapped());
+            ASSERT_EQ(batch->just_swapped(game), expected.just_swapped());
+            ASSERT_EQ(current.shape, expected.current().shape);
+            ASSERT_EQ(current.rotation, expected.current().rotation);
+            ASSERT_EQ(current.coordinates.x, expected.current().coordinates.x);
+            ASSERT_EQ(current.coordinates.y, expected.current().coordinates.y);
+            ASSERT_TRUE(std::ranges::equal(batch->occupancy(game).rows(), expected.occupancy().rows()));
+        }
+    }
+
+    EXPECT_TRUE(std::ranges::all_of(reference, &tetriz::Game::finished));
+}
+
+TEST(GameBatch, ClearsLinesLikeGame)
+{
+    constexpr auto games = 4uz;
+
+    auto seeds = std::array<uint32_t, games>{ 1, 2, 3, 4 };
+    auto batch = tetriz::GameBatch<games>(seeds);
+    auto reference = std::vector<tetriz::Game>(seeds.begin(), seeds.end());
+
+    auto pool = ThreadPool(1);
+    const auto bot = tetriz::bot::Bot(pool, {}, { .depth = 1 });
+
+    for (auto piece = 0; piece < 60; ++piece)
+        for (auto game = 0uz; game < games; ++game)
+        {
+            const auto decision = bot.decide(reference[game]);
+            ASSERT_TRUE(decision);
+
+            if (decision->swap)
+                batch.apply(game, tetriz::Move::Swap);
+
+            batch.place(game, decision->placement);
+            tetriz::bot::apply(reference[game], *decision);
+
+            ASSERT_EQ(batch.score(game), reference[game].score());
+            ASSERT_EQ(batch.current(game).shape, reference[game].current().shape);
+            ASSERT_TRUE(std::ranges::equal(batch.occupancy(game).rows(), reference[game].occupancy().rows()));
+        }
+
+    EXPECT_TRUE(std::ranges::all_of(reference, [](const auto& game) { return game.score() > 0; }));
+}
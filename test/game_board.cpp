@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <array>
+
+#include "gtest/gtest.h"
+
+#include "engine/game.hpp"
+#include "engine/game_board.hpp"
+#include "proto/protocol.hpp"
+
+
+namespace
+{
+    // Every row marked by its original index, so moved rows can be told apart
+    auto numbered_rows() -> tetriz::BoardRows
+    {
+        auto rows = tetriz::BoardRows{};
+        for (auto y = 0uz; y < rows.size(); ++y)
+            rows[y][y % tetriz::board_width] = static_cast<tetriz::Block>(y % 7 + 1);
+
+        return rows;
+    }
+
+    // What clearing the rows does when every row is copied down
+    auto cleared_by_copying(tetriz::BoardRows rows, int y, uint8_t cleared) -> tetriz::BoardRows
+    {
+        for (auto row = y; row < y + 4; ++row)
+            if (cleared >> (row - y) & 1)
+            {
+                std::ranges::copy_backward(rows.begin(), rows.begin() + row, rows.begin() + row + 1);
+                rows[0] = {};
+            }
+
+        return rows;
+    }
+}
+
+
+TEST(GameBoard, ClearRowsMatchesCopyingRowsDown)
+{
+    for (auto y = 0; y <= static_cast<int>(tetriz::board_height) - 4; ++y)
+        for (auto cleared = uint8_t{1}; cleared < 16; ++cleared)
+        {
+            auto board = tetriz::Board(numbered_rows());
+            board.clear_rows(y, cleared);
+
+            ASSERT_EQ(board.rows(), cleared_by_copying(numbered_rows(), y, cleared));
+        }
+}
+
+TEST(GameBoard, RepeatedClearsReuseStorageRowsEmpty)
+{
+    auto board = tetriz::Board(numbered_rows());
+    auto copied = numbered_rows();
+
+    for (auto round = 0; round < 30; ++round)
+    {
+        const auto y = round % 19;
+        const auto cleared = static_cast<uint8_t>(round % 15 + 1);
+
+        board.clear_rows(y, cleared);
+        copied = cleared_by_copying(copied, y, cleared);
+        board[0][round % tetriz::board_width] = tetriz::Block::Red;
+        copied[0][round % tetriz::board_width] = tetriz::Block::Red;
+
+        ASSERT_EQ(board.rows(), copied);
+    }
+}
+
+TEST(GameBoard, DatagramCarriesRowsInBoardOrder)
+{
+    auto game = tetriz::Game(3);
+    for (auto piece = 0; piece < 40 && !game.finished(); ++piece)
+        game.drop();
+
+    const auto message = tetriz::proto::serialize_game(2, game);
+    static_assert(message.size() == tetriz::proto::pack_size<
+        tetriz::proto::MessageType, uint8_t, tetriz::BoardRows, tetriz::Tetromino,
+        std::optional<tetriz::TetrominoShape>, tetriz::proto::Bag, uint16_t>);
+
+    const auto datagram = tetriz::proto::deserialize(message);
+    ASSERT_TRUE(datagram);
+
+    const auto& received = std::get<tetriz::proto::DatagramGame>(datagram->payload);
+    EXPECT_EQ(received.board.rows(), game.board().rows());
+}
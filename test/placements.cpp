@@ -0,0 +1,49 @@
+#include <set>
+#include <tuple>
+
+#include "gtest/gtest.h"
+
+#include "engine/placements.hpp"
+
+
+TEST(Placements, EveryPlacementRestsAndIsUnique)
+{
+    auto game = tetriz::Game(21);
+
+    for (auto round = 0; round < 40 && !game.finished(); ++round)
+    {
+        const auto placements = tetriz::find_placements(game);
+        ASSERT_FALSE(placements.empty());
+
+        auto seen = std::set<std::tuple<int, int, tetriz::TetrominoRotation>>{};
+        for (const auto& placement : placements)
+        {
+            auto below = placement;
+            ++below.coordinates.y;
+
+            ASSERT_EQ(placement.shape, game.current().shape);
+            ASSERT_TRUE(tetriz::fits(game.occupancy(), placement));
+            ASSERT_FALSE(tetriz::fits(game.occupancy(), below));
+            ASSERT_TRUE(seen.emplace(placement.coordinates.x, placement.coordinates.y, placement.rotation).second);
+        }
+
+        ASSERT_TRUE(std::ranges::any_of(placements, [&](const auto& placement) {
+            return placement.rotation == game.ghost().rotation
+                && placement.coordinates.x == game.ghost().coordinates.x
+                && placement.coordinates.y == game.ghost().coordinates.y;
+        }));
+
+        game.place(placements[(round * 7) % placements.size()]);
+    }
+}
+
+TEST(Placements, OpenBoardCoversEveryColumnAndRotation)
+{
+    const auto board = tetriz::BitBoard{};
+    auto placements = tetriz::PlacementList{};
+
+    find_placements(board, { .shape = tetriz::TetrominoShape::T, .coordinates = { 3, 1 } }, placements);
+
+    // 8 columns for each flat rotation, 9 for each upright one
+    ASSERT_EQ(placements.size(), 8 + 9 + 8 + 9);
+}
@@ -0,0 +1,34 @@
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "proto/protocol.hpp"
+
+
+TEST(Protocol, MoveRunsLongerThanTheBufferAreReadInChunks)
+{
+    auto sent = std::vector<tetriz::proto::Move>{};
+    auto message = std::vector<uint8_t>{};
+    for (auto index = 0uz; index < 150; ++index)
+    {
+        sent.push_back(static_cast<tetriz::proto::Move>(index % 6));
+        const auto datagram = tetriz::proto::serialize_move(sent.back());
+        message.insert(message.end(), datagram.begin(), datagram.end());
+    }
+
+    const auto time = tetriz::proto::serialize_time(Duration(3));
+    message.insert(message.end(), time.begin(), time.end());
+
+    auto received = std::vector<tetriz::proto::Move>{};
+    auto moves = std::array<tetriz::proto::Move, 64>{};
+    auto rest = std::span<const uint8_t>(message);
+    while (const auto count = tetriz::proto::deserialize_moves(rest, moves))
+    {
+        received.insert(received.end(), moves.begin(), moves.begin() + count);
+        rest = rest.subspan(count * tetriz::proto::move_datagram_size);
+    }
+
+    EXPECT_EQ(received, sent);
+    EXPECT_EQ(rest.size(), time.size());
+}
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "engine/random.hpp"
+#include "proto/replay.hpp"
+
+
+namespace
+{
+    // A room of players that all started from the seed and pressed random keys until they topped out
+    auto record_room(uint32_t seed, size_t players) -> tetriz::proto::Replay
+    {
+        auto replay = tetriz::proto::Replay{ .seed = seed };
+
+        for (auto player = 0uz; player < players; ++player)
+        {
+            auto game = tetriz::Game(seed);
+            auto random = tetriz::Pcg32(player);
+            auto recording = tetriz::proto::ReplayPlayer{};
+
+            for (auto step = 0; !game.finished() && step < 5000; ++step)
+            {
+                const auto move = static_cast<tetriz::Move>(tetriz::uniform_below(random, 6));
+                game.apply(move);
+                recording.inputs.push_back({ Duration(step), move });
+            }
+
+            recording.final_hash = game.hash();
+            replay.players.push_back(recording);
+        }
+
+        return replay;
+    }
+
+    auto replay_bytes(const tetriz::proto::Replay& replay) -> std::string
+    {
+        auto stream = std::ostringstream();
+        tetriz::proto::write_replay(stream, replay);
+        return stream.str();
+    }
+
+    template <typename T>
+    auto patched_replay(std::string bytes, size_t offset, T value) -> std::string
+    {
+        bytes.replace(offset, sizeof(value), reinterpret_cast<const char*>(&value), sizeof(value));
+        return bytes;
+    }
+
+    auto reads_back(const std::string& bytes) -> bool
+    {
+        auto stream = std::istringstream(bytes);
+        return tetriz::proto::read_replay(stream).has_value();
+    }
+}
+
+
+TEST(Replay, RoundTripsAndPlaysBackToTheRecordedState)
+{
+    const auto recorded = record_room(77, 3);
+
+    auto stream = std::istringstream(replay_bytes(recorded));
+    const auto replay = tetriz::proto::read_replay(stream);
+    ASSERT_TRUE(replay);
+    ASSERT_EQ(replay->seed, recorded.seed);
+    ASSERT_EQ(replay->engine, tetriz::proto::engine_version);
+    ASSERT_EQ(replay->players.size(), recorded.players.size());
+
+    for (auto player = 0uz; player < replay->players.size(); ++player)
+    {
+        const auto& inputs = replay->players[player].inputs;
+        ASSERT_EQ(inputs.size(), recorded.players[player].inputs.size());
+        ASSERT_EQ(inputs.back().timestamp, recorded.players[player].inputs.back().timestamp);
+        ASSERT_EQ(tetriz::proto::simulate(*replay, player).hash(), recorded.players[player].final_hash);
+    }
+}
+
+TEST(Replay, RejectsTruncatedAndForeignFiles)
+{
+    const auto bytes = replay_bytes(record_room(5, 2));
+
+    for (const auto length : { 0uz, 10uz, bytes.size() / 2, bytes.size() - 1 })
+    {
+        auto stream = std::istringstream(bytes.substr(0, length));
+        EXPECT_FALSE(tetriz::proto::read_replay(stream)) << length;
+    }
+
+    auto foreign = bytes;
+    foreign[0] = 'X';
+    auto stream = std::istringstream(foreign);
+    EXPECT_FALSE(tetriz::proto::read_replay(stream));
+}
+
+TEST(Replay, RejectsCountsLargerThanTheFile)
+{
+    using namespace tetriz::proto;
+
+    auto recorded = record_room(9, 2);
+    add_keyframes(recorded, 5);
+    const auto bytes = replay_bytes(recorded);
+
+    const auto first = sizeof(ReplayHeader);
+    const auto second = first + sizeof(ReplayPlayerHeader);
+    for (const auto offset : { first + offsetof(ReplayPlayerHeader, input_count), second + offsetof(ReplayPlayerHeader, input_count),
+                               first + offsetof(ReplayPlayerHeader, keyframe_count), second + offsetof(ReplayPlayerHeader, keyframe_count) })
+        EXPECT_FALSE(reads_back(patched_replay(bytes, offset, UINT32_MAX))) << offset;
+
+    EXPECT_FALSE(reads_back(patched_replay(bytes, offsetof(ReplayHeader, room_size), UINT16_MAX)));
+}
+
+TEST(Replay, SeekFromKeyframesMatchesPlayingFromTheStart)
+{
+    auto recorded = record_room(13, 2);
+    tetriz::proto::add_keyframes(recorded, 2);
+
+    auto stream = std::istringstream(replay_bytes(recorded));
+    const auto replay = tetriz::proto::read_replay(stream);
+    ASSERT_TRUE(replay);
+
+    for (auto player = 0uz; player < replay->players.size(); ++player)
+    {
+        const auto& keyframes = replay->players[player].keyframes;
+        const auto& inputs = replay->players[player].inputs;
+        ASSERT_GT(keyframes.size(), 2);
+        ASSERT_EQ(keyframes.size(), recorded.players[player].keyframes.size());
+
+        // Every input is a timestamp of its own, step by step the prefix is the expected state
+        auto game = tetriz::Game(replay->seed);
+        for (const auto& input : inputs)
+        {
+            game.apply(input.move);
+            ASSERT_EQ(tetriz::proto::seek(*replay, player, input.timestamp).hash(), game.hash());
+        }
+
+        for (const auto& keyframe : keyframes)
+            ASSERT_EQ(tetriz::Game(keyframe.snapshot).hash(),
+                      tetriz::proto::seek(*replay, player, keyframe.timestamp).hash());
+    }
+}
+
+TEST(Replay, RejectsInputsAndKeyframesOutOfOrder)
+{
+    using namespace tetriz::proto;
+
+    auto recorded = record_room(34, 1);
+    add_keyframes(recorded, 5);
+    const auto& player = recorded.players.front();
+    ASSERT_GE(player.keyframes.size(), 2);
+
+    const auto bytes = replay_bytes(recorded);
+    ASSERT_TRUE(reads_back(bytes));
+
+    const auto inputs = sizeof(ReplayHeader) + sizeof(ReplayPlayerHeader);
+    const auto entries = inputs + player.inputs.size() * sizeof(ReplayInput);
+    const auto entry = [&](size_t index, size_t field) { return entries + index * sizeof(ReplayKeyframeEntry) + field; };
+
+    EXPECT_FALSE(reads_back(patched_replay(bytes, inputs + offsetof(ReplayInput, move), uint8_t{6})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, inputs + offsetof(ReplayInput, timestamp), Duration(1'000'000))));
+
+    const auto second = player.keyframes[1];
+    EXPECT_FALSE(reads_back(patched_replay(bytes, entry(0, 0), ReplayKeyframeEntry{ second.input_index, second.timestamp })));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, entry(0, offsetof(ReplayKeyframeEntry, input_index)), uint32_t{0})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, entry(0, offsetof(ReplayKeyframeEntry, timestamp)), second.timestamp)));
+}
+
+TEST(Replay, RejectsKeyframeSnapshotsTheEngineCannotProduce)
+{
+    using namespace tetriz::proto;
+
+    auto recorded = record_room(55, 1);
+    add_keyframes(recorded, 5);
+    const auto& player = recorded.players.front();
+    ASSERT_FALSE(player.keyframes.empty());
+
+    const auto bytes = replay_bytes(recorded);
+    const auto snapshot = sizeof(ReplayHeader) + sizeof(ReplayPlayerHeader)
+        + player.inputs.size() * sizeof(ReplayInput)
+        + player.keyframes.size() * sizeof(ReplayKeyframeEntry);
+    const auto current = snapshot + offsetof(ReplaySnapshot, current);
+
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, board), uint8_t{8})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, bag), uint8_t{200})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, current + offsetof(tetriz::Tetromino, shape), uint8_t{0})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, current + offsetof(tetriz::Tetromino, rotation), uint8_t{4})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, current + offsetof(tetriz::Tetromino, coordinates), int8_t{-100})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, swapped), uint8_t{8})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, just_swapped), uint8_t{2})));
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, finished), uint8_t{255})));
+}
+
+TEST(Replay, RejectsKeyframePiecesOffTheBoardOrInTheStack)
+{
+    using namespace tetriz::proto;
+
+    auto recorded = record_room(55, 1);
+    add_keyframes(recorded, 5);
+    const auto& player = recorded.players.front();
+    ASSERT_FALSE(player.keyframes.empty());
+    ASSERT_FALSE(player.keyframes.front().snapshot.finished);
+
+    const auto bytes = replay_bytes(recorded);
+    const auto snapshot = sizeof(ReplayHeader) + sizeof(ReplayPlayerHeader)
+        + player.inputs.size() * sizeof(ReplayInput)
+        + player.keyframes.size() * sizeof(ReplayKeyframeEntry);
+
+    // Inside the board by its origin, but the I sticks out past the right wall
+    const auto overhanging = tetriz::Tetromino{ tetriz::TetrominoShape::I, tetriz::TetrominoRotation::Base, { 9, 1 } };
+    EXPECT_FALSE(reads_back(patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, current), overhanging)));
+
+    // A piece inside the stack is how a game ends, anywhere else it cannot happen
+    auto row = tetriz::BoardRow{};
+    std::ranges::fill(row, tetriz::Block::Cyan);
+    auto full = tetriz::BoardRows{};
+    std::ranges::fill(full, row);
+    const auto buried = patched_replay(bytes, snapshot + offsetof(ReplaySnapshot, board), full);
+    EXPECT_FALSE(reads_back(buried));
+    EXPECT_TRUE(reads_back(patched_replay(buried, snapshot + offsetof(ReplaySnapshot, finished), uint8_t{1})));
+}
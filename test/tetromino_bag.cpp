@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "engine/tetromino_bag.hpp"
+
+
+TEST(TetrominoBag, BulkPollMatchesSinglePolls)
+{
+    auto single = tetriz::TetrominoBag(42);
+    auto bulk = tetriz::TetrominoBag(42);
+
+    for (const auto count : {1uz, 3uz, 7uz, 13uz, 64uz, 5uz})
+    {
+        auto pieces = std::vector<tetriz::TetrominoShape>(count);
+        bulk.poll(pieces);
+
+        for (const auto piece : pieces)
+            ASSERT_EQ(piece, single.poll());
+
+        ASSERT_EQ(bulk.peek<7>(), single.peek<7>());
+    }
+}
+
+TEST(TetrominoBag, EveryBagHoldsEachShapeOnce)
+{
+    auto bag = tetriz::TetrominoBag(7);
+    auto pieces = std::array<tetriz::TetrominoShape, 7 * 100>{};
+    bag.poll(pieces);
+
+    for (auto begin = pieces.begin(); begin != pieces.end(); begin += 7)
+    {
+        auto sorted = std::array<tetriz::TetrominoShape, 7>{};
+        std::ranges::copy_n(begin, 7, sorted.begin());
+        std::ranges::sort(sorted);
+
+        ASSERT_TRUE(std::ranges::equal(sorted, magic_enum::enum_values<tetriz::TetrominoShape>()));
+    }
+}
+
+TEST(TetrominoBag, SeekMatchesPolling)
+{
+    auto polled = tetriz::SeekableTetrominoBag(1234);
+
+    for (auto index = 0u; index < 200; ++index)
+    {
+        auto seeked = tetriz::SeekableTetrominoBag(1234);
+        seeked.seek(index);
+
+        ASSERT_EQ(seeked.peek<7>(), polled.peek<7>());
+        ASSERT_EQ(seeked.hash(), polled.hash());
+        ASSERT_EQ(seeked.poll(), polled.poll());
+    }
+}
+
+TEST(TetrominoBag, SlotKeysDifferForEveryShapeAndEmptySlot)
+{
+    using Keys = tetriz::zobrist::BagKeys<14>;
+
+    auto keys = std::set<uint64_t>{};
+    for (auto slot = 0uz; slot < 14; ++slot)
+    {
+        keys.insert(Keys::slot(slot, tetriz::TetrominoShape{}));
+        for (const auto shape : magic_enum::enum_values<tetriz::TetrominoShape>())
+            keys.insert(Keys::slot(slot, shape));
+    }
+
+    EXPECT_EQ(keys.size(), 14 * (magic_enum::enum_count<tetriz::TetrominoShape>() + 1));
+}